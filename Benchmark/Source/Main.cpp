@@ -0,0 +1,316 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Benchmark: drives BitCrusherAudioProcessor::processBlock with synthetic
+    audio over a grid of block sizes, sample rates, channel counts and
+    parameter settings, times state save/load and program switching, and
+    writes the timings out as JSON.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct ParameterSetting
+    {
+        juce::String name;
+        std::vector<std::pair<juce::String, float>> values;
+    };
+
+    struct BenchmarkConfig
+    {
+        juce::Array<double> sampleRates{ 44100.0, 48000.0, 96000.0, 192000.0 };
+        juce::Array<int> blockSizes{ 16, 64, 256, 1024, 4096 };
+        juce::Array<int> channelCounts{ 1, 2, 8, 12 };
+        std::vector<ParameterSetting> settings;
+        int minBlocks = 2000;
+        double minSeconds = 2.0;
+        juce::File outputFile{ juce::File::getCurrentWorkingDirectory().getChildFile("benchmark_results.json") };
+    };
+
+    struct RunResult
+    {
+        double nsPerSample = 0.0;
+        double realtimeFactor = 0.0;
+        double meanBlockUs = 0.0;
+        double p99BlockUs = 0.0;
+        double p999BlockUs = 0.0;
+        double worstBlockUs = 0.0;
+        int numBlocks = 0;
+    };
+
+    //the handful of settings that cover the common cases, --full swaps these for the whole grid
+    std::vector<ParameterSetting> getDefaultSettings()
+    {
+        return {
+            { "clean",          {} },
+            { "crushed",        { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "mix", 1.f } } },
+            { "extreme",        { { "bitDepth", 1.f }, { "bitRate", 100.f }, { "cutoff", 100.f }, { "mix", .5f } } },
+            { "crushed 2x",     { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "oversampling", 1.f } } },
+            { "crushed 8x",     { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "oversampling", 3.f } } },
+            //against "crushed", these show what each dither mode adds per sample
+            { "crushed rpdf",   { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "dither", 1.f } } },
+            { "crushed tpdf",   { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "dither", 2.f } } },
+            { "crushed shaped", { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "dither", 3.f } } },
+            //the filter bank from the old first order section up to the longest cascade
+            { "crushed 1st",    { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "filterType", 0.f } } },
+            { "crushed 8th",    { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "filterType", 1.f }, { "filterOrder", 2.f } } },
+            //multiband, the second has its low band's mix at 0 so it only pays for the split there
+            { "bands 4",        { { "bands", 3.f }, { "cutoff", 4000.f }, { "band1Depth", 4.f }, { "band2Depth", 4.f }, { "band3Depth", 4.f }, { "band4Depth", 4.f },
+                                  { "band1Rate", 8000.f }, { "band2Rate", 8000.f }, { "band3Rate", 8000.f }, { "band4Rate", 8000.f } } },
+            { "bands 2 skip",   { { "bands", 1.f }, { "cutoff", 4000.f }, { "band1Mix", 0.f }, { "band2Depth", 4.f }, { "band2Rate", 8000.f } } },
+        };
+    }
+
+    std::vector<ParameterSetting> getFullSettings()
+    {
+        std::vector<ParameterSetting> settings;
+
+        for (auto depth : { 1.f, 4.f, 8.f, 12.f, 16.f })
+            for (auto rate : { 100.f, 1000.f, 10000.f, 192000.f })
+                for (auto cutoff : { 100.f, 1000.f, 20000.f })
+                    for (auto mix : { 0.f, .5f, 1.f })
+                        settings.push_back({ "depth " + juce::String(depth) + " rate " + juce::String(rate) + " cutoff " + juce::String(cutoff) + " mix " + juce::String(mix),
+                                             { { "bitDepth", depth }, { "bitRate", rate }, { "cutoff", cutoff }, { "mix", mix } } });
+
+        return settings;
+    }
+
+    void applySetting(BitCrusherAudioProcessor& processor, const ParameterSetting& setting)
+    {
+        for (auto& [id, value] : setting.values)
+        {
+            auto* param = processor.apvts.getParameter(id);
+            jassert(param != nullptr);
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        }
+    }
+
+    //noise over a slow sine, something the crusher has to actually work on
+    void fillTestSignal(juce::AudioBuffer<float>& source, double sampleRate)
+    {
+        juce::Random random(1234);
+
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+        {
+            auto* data = source.getWritePointer(ch);
+            for (int s = 0; s < source.getNumSamples(); ++s)
+                data[s] = .7f * std::sin(juce::MathConstants<float>::twoPi * 220.f * static_cast<float>(s / sampleRate))
+                        + .2f * (random.nextFloat() * 2.f - 1.f);
+        }
+    }
+
+    double percentile(std::vector<double>& sorted, double fraction)
+    {
+        auto index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + .5);
+        return sorted[juce::jmin(index, sorted.size() - 1)];
+    }
+
+    RunResult runBenchmark(const ParameterSetting& setting, double sampleRate, int blockSize, int numChannels, const BenchmarkConfig& config)
+    {
+        BitCrusherAudioProcessor processor;
+        //12 channels is benchmarked as a 7.1.4 bed rather than a discrete set
+        auto layout = numChannels == 12 ? juce::AudioChannelSet::create7point1point4()
+                                        : juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+        BitCrusherAudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(layout);
+        buses.outputBuses.add(layout);
+        processor.setBusesLayout(buses);
+
+        applySetting(processor, setting);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        //one second of source audio, looped through the blocks
+        juce::AudioBuffer<float> source(numChannels, static_cast<int>(sampleRate));
+        fillTestSignal(source, sampleRate);
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        auto numBlocks = juce::jmax(config.minBlocks, static_cast<int>(config.minSeconds * sampleRate / blockSize));
+        auto warmupBlocks = juce::jmax(16, numBlocks / 20);
+
+        std::vector<double> blockTimes;
+        blockTimes.reserve(static_cast<size_t>(numBlocks));
+
+        int readPos = 0;
+        double totalSeconds = 0.0;
+
+        for (int block = -warmupBlocks; block < numBlocks; ++block)
+        {
+            if (readPos + blockSize > source.getNumSamples())
+                readPos = 0;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom(ch, 0, source, ch, readPos, blockSize);
+
+            readPos += blockSize;
+
+            auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            if (block >= 0)
+            {
+                blockTimes.push_back(elapsed);
+                totalSeconds += elapsed;
+            }
+        }
+
+        processor.releaseResources();
+
+        RunResult result;
+        auto totalSamples = static_cast<double>(numBlocks) * blockSize;
+
+        result.numBlocks = numBlocks;
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+        result.realtimeFactor = (totalSamples / sampleRate) / totalSeconds;
+        result.meanBlockUs = totalSeconds * 1.0e6 / numBlocks;
+
+        std::sort(blockTimes.begin(), blockTimes.end());
+        result.p99BlockUs = percentile(blockTimes, .99) * 1.0e6;
+        result.p999BlockUs = percentile(blockTimes, .999) * 1.0e6;
+        result.worstBlockUs = blockTimes.back() * 1.0e6;
+
+        return result;
+    }
+
+    struct StateResult
+    {
+        double saveUs = 0.0;
+        double loadUs = 0.0;
+        double programUs = 0.0;
+        int stateBytes = 0;
+    };
+
+    //what the host pays per instance for undo snapshots, session saves and preset switching
+    StateResult runStateBenchmark(const BenchmarkConfig& config)
+    {
+        BitCrusherAudioProcessor processor;
+        applySetting(processor, getDefaultSettings()[1]);
+
+        const auto iterations = config.minBlocks * 10;
+        juce::MemoryBlock state;
+        StateResult result;
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < iterations; ++i)
+            processor.getStateInformation(state);
+        result.saveUs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e6 / iterations;
+        result.stateBytes = static_cast<int>(state.getSize());
+
+        start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < iterations; ++i)
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        result.loadUs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e6 / iterations;
+
+        start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < iterations; ++i)
+            processor.setCurrentProgram(i % processor.getNumPrograms());
+        result.programUs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e6 / iterations;
+
+        return result;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    BenchmarkConfig config;
+    config.settings = getDefaultSettings();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(juce::CharPointer_UTF8(argv[i]));
+
+        if (arg == "--full")
+            config.settings = getFullSettings();
+        else if (arg == "--quick")
+        {
+            config.minBlocks = 200;
+            config.minSeconds = .25;
+        }
+        else if (arg == "--out" && i + 1 < argc)
+            config.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(juce::CharPointer_UTF8(argv[++i]));
+        else
+        {
+            std::cout << "Usage: BitCrusherBenchmark [--full] [--quick] [--out results.json]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    juce::Array<juce::var> runs;
+
+    std::cout << juce::String("setting").paddedRight(' ', 24) << juce::String("rate").paddedLeft(' ', 8) << juce::String("block").paddedLeft(' ', 7)
+              << juce::String("ch").paddedLeft(' ', 4) << juce::String("ns/smp").paddedLeft(' ', 10) << juce::String("x rt").paddedLeft(' ', 10)
+              << juce::String("p99 us").paddedLeft(' ', 10) << juce::String("p99.9 us").paddedLeft(' ', 10) << juce::String("worst us").paddedLeft(' ', 10) << std::endl;
+
+    for (auto& setting : config.settings)
+    {
+        for (auto sampleRate : config.sampleRates)
+        {
+            for (auto blockSize : config.blockSizes)
+            {
+                for (auto numChannels : config.channelCounts)
+                {
+                    auto result = runBenchmark(setting, sampleRate, blockSize, numChannels, config);
+
+                    std::cout << setting.name.paddedRight(' ', 24) << juce::String(sampleRate, 0).paddedLeft(' ', 8) << juce::String(blockSize).paddedLeft(' ', 7)
+                              << juce::String(numChannels).paddedLeft(' ', 4) << juce::String(result.nsPerSample, 2).paddedLeft(' ', 10)
+                              << juce::String(result.realtimeFactor, 0).paddedLeft(' ', 10) << juce::String(result.p99BlockUs, 2).paddedLeft(' ', 10)
+                              << juce::String(result.p999BlockUs, 2).paddedLeft(' ', 10) << juce::String(result.worstBlockUs, 2).paddedLeft(' ', 10) << std::endl;
+
+                    auto* run = new juce::DynamicObject();
+                    run->setProperty("setting", setting.name);
+                    run->setProperty("sampleRate", sampleRate);
+                    run->setProperty("blockSize", blockSize);
+                    run->setProperty("channels", numChannels);
+                    run->setProperty("blocks", result.numBlocks);
+                    run->setProperty("nsPerSample", result.nsPerSample);
+                    run->setProperty("realtimeFactor", result.realtimeFactor);
+                    run->setProperty("meanBlockUs", result.meanBlockUs);
+                    run->setProperty("p99BlockUs", result.p99BlockUs);
+                    run->setProperty("p999BlockUs", result.p999BlockUs);
+                    run->setProperty("worstBlockUs", result.worstBlockUs);
+                    runs.add(juce::var(run));
+                }
+            }
+        }
+    }
+
+    auto stateResult = runStateBenchmark(config);
+    std::cout << "state: " << stateResult.stateBytes << " bytes, save " << juce::String(stateResult.saveUs, 3) << " us, load "
+              << juce::String(stateResult.loadUs, 3) << " us, program switch " << juce::String(stateResult.programUs, 3) << " us" << std::endl;
+
+    auto* stateRun = new juce::DynamicObject();
+    stateRun->setProperty("bytes", stateResult.stateBytes);
+    stateRun->setProperty("saveUs", stateResult.saveUs);
+    stateRun->setProperty("loadUs", stateResult.loadUs);
+    stateRun->setProperty("programUs", stateResult.programUs);
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("plugin", "BitCrusher");
+    root->setProperty("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("runs", runs);
+    root->setProperty("state", juce::var(stateRun));
+
+    if (! config.outputFile.replaceWithText(juce::JSON::toString(juce::var(root))))
+    {
+        std::cout << "Couldn't write " << config.outputFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Results written to " << config.outputFile.getFullPathName() << std::endl;
+    return 0;
+}
@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+
+    GoldenCheck.cpp
+    Created: 17 Oct 2026 11:26:08pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "GoldenCheck.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct Setting
+    {
+        juce::String name;
+        std::vector<std::pair<juce::String, float>> values;
+    };
+
+    //one case per stage and mode of the chain, the values are plain parameter values, choices by index
+    const std::vector<Setting>& getSettings()
+    {
+        static const std::vector<Setting> settings{
+            { "clean",        {} },
+            { "crushed",      { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f } } },
+            { "extreme",      { { "bitDepth", 1.f }, { "bitRate", 100.f }, { "cutoff", 100.f }, { "mix", .5f } } },
+            { "fractional",   { { "bitDepth", 5.5f }, { "bitRate", 11025.f }, { "cutoff", 6000.f } } },
+            { "equal power",  { { "bitDepth", 6.f }, { "bitRate", 16000.f }, { "mix", .5f }, { "mixLaw", 1.f } } },
+            { "oversampled 2x", { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "oversampling", 1.f } } },
+            { "oversampled 8x", { { "bitDepth", 4.f }, { "bitRate", 8000.f }, { "cutoff", 4000.f }, { "oversampling", 3.f } } },
+            { "rpdf",         { { "bitDepth", 6.f }, { "dither", 1.f } } },
+            { "tpdf",         { { "bitDepth", 6.f }, { "dither", 2.f } } },
+            { "shaped",       { { "bitDepth", 6.f }, { "dither", 3.f } } },
+            { "first order",  { { "bitDepth", 8.f }, { "cutoff", 2000.f }, { "filterType", 0.f } } },
+            { "butterworth 8th", { { "bitDepth", 8.f }, { "cutoff", 2000.f }, { "filterType", 1.f }, { "filterOrder", 2.f } } },
+            { "chebyshev 4th", { { "bitDepth", 8.f }, { "cutoff", 2000.f }, { "filterType", 2.f }, { "filterOrder", 1.f }, { "resonance", .6f } } },
+            { "svf 8th",      { { "bitDepth", 8.f }, { "cutoff", 2000.f }, { "filterType", 3.f }, { "filterOrder", 2.f }, { "resonance", .8f } } },
+            { "multiband 2",  { { "bands", 1.f }, { "crossover1", 3000.f }, { "band1Mix", 0.f }, { "band2Depth", 4.f }, { "band2Rate", 11025.f } } },
+            { "multiband 4",  { { "bands", 3.f }, { "band1Depth", 3.f }, { "band2Depth", 6.f }, { "band2Mix", .5f }, { "band3Rate", 8000.f }, { "band4Depth", 5.5f } } },
+        };
+
+        return settings;
+    }
+
+    const juce::StringArray signalNames{ "sine", "sweep", "impulses", "noise" };
+    const juce::Array<double> sampleRates{ 44100.0, 96000.0 };
+
+    //the first one renders the references, the rest are odd, tiny and huge on purpose
+    const juce::Array<int> blockSizes{ 512, 7, 64, 1000, 4096 };
+
+    constexpr double signalSeconds = .5;
+    constexpr int numChannels = 2;
+
+    juce::AudioBuffer<float> makeSignal(const juce::String& name, double sampleRate)
+    {
+        const auto numSamples = juce::roundToInt(sampleRate * signalSeconds);
+        const auto twoPi = juce::MathConstants<double>::twoPi;
+        juce::AudioBuffer<float> signal(numChannels, numSamples);
+        signal.clear();
+
+        auto* left = signal.getWritePointer(0);
+        auto* right = signal.getWritePointer(1);
+
+        if (name == "sine")
+        {
+            for (int s = 0; s < numSamples; ++s)
+            {
+                left[s] = static_cast<float>(.7 * std::sin(twoPi * 440.0 * s / sampleRate));
+                right[s] = static_cast<float>(.5 * std::sin(twoPi * 1000.0 * s / sampleRate));
+            }
+        }
+        else if (name == "sweep")
+        {
+            //exponential 20 Hz to 20 kHz, the phase is the integral of the frequency
+            const auto k = std::log(1000.0) / signalSeconds;
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                auto t = s / sampleRate;
+                auto y = .8 * std::sin(twoPi * 20.0 * (std::exp(k * t) - 1.0) / k);
+                left[s] = static_cast<float>(y);
+                right[s] = static_cast<float>(-.5 * y);
+            }
+        }
+        else if (name == "impulses")
+        {
+            //ten a second with the sign flipping, the right side lands in between. the gaps are long enough for the silence idling to kick in
+            const auto spacing = juce::roundToInt(sampleRate / 10.0);
+
+            for (int s = 0, i = 0; s < numSamples; s += spacing, ++i)
+            {
+                left[s] = i % 2 == 0 ? 1.f : -1.f;
+                right[juce::jmin(numSamples - 1, s + spacing / 2)] = .5f;
+            }
+        }
+        else
+        {
+            juce::Random random(0x5eed);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int s = 0; s < numSamples; ++s)
+                    signal.setSample(ch, s, .5f * (random.nextFloat() * 2.f - 1.f));
+        }
+
+        return signal;
+    }
+
+    //the input through a fresh processor, lined up with the input the same way the renderer does it
+    juce::AudioBuffer<float> render(const Setting& setting, const juce::AudioBuffer<float>& input, double sampleRate, int blockSize)
+    {
+        BitCrusherAudioProcessor processor;
+
+        for (auto& [id, value] : setting.values)
+        {
+            auto* param = processor.apvts.getParameter(id);
+            jassert(param != nullptr);
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        }
+
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto length = input.getNumSamples();
+        const auto latency = processor.getLatencySamples();
+        juce::AudioBuffer<float> output(numChannels, length);
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int pos = 0; pos < length + latency; pos += blockSize)
+        {
+            const auto numSamples = juce::jmin(blockSize, length + latency - pos);
+            const auto numInput = juce::jlimit(0, numSamples, length - pos);
+            block.setSize(numChannels, numSamples, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                block.clear(ch, 0, numSamples);
+                if (numInput > 0)
+                    block.copyFrom(ch, 0, input, ch, pos, numInput);
+            }
+
+            processor.processBlock(block, midi);
+
+            //everything before the latency is the oversampler filling up
+            const auto skip = juce::jlimit(0, numSamples, latency - pos);
+            for (int ch = 0; ch < numChannels && skip < numSamples; ++ch)
+                output.copyFrom(ch, pos + skip - latency, block, ch, skip, numSamples - skip);
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+
+    struct Difference
+    {
+        bool exact = true;
+        double maxError = 0.0;
+        double rmsDb = -300.0;
+    };
+
+    Difference compare(const juce::AudioBuffer<float>& golden, const juce::AudioBuffer<float>& output)
+    {
+        Difference d;
+        double sumOfSquares = 0.0;
+        const auto numSamples = golden.getNumSamples();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* a = golden.getReadPointer(ch);
+            const auto* b = output.getReadPointer(ch);
+
+            if (std::memcmp(a, b, sizeof(float) * static_cast<size_t>(numSamples)) == 0)
+                continue;
+
+            d.exact = false;
+
+            for (int s = 0; s < numSamples; ++s)
+            {
+                auto e = static_cast<double>(a[s]) - static_cast<double>(b[s]);
+                d.maxError = juce::jmax(d.maxError, std::abs(e));
+                sumOfSquares += e * e;
+            }
+        }
+
+        if (sumOfSquares > 0.0)
+            d.rmsDb = 10.0 * std::log10(sumOfSquares / static_cast<double>(numSamples * numChannels));
+
+        return d;
+    }
+
+    bool writeGolden(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        //32 bit wav is float, so the file holds exactly what the processor put out
+        std::unique_ptr<juce::AudioFormatWriter> writer(juce::WavAudioFormat().createWriterFor(stream.get(), sampleRate, numChannels, 32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readGolden(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(juce::WavAudioFormat().createReaderFor(file.createInputStream().release(), true));
+        if (reader == nullptr || static_cast<int>(reader->numChannels) != numChannels)
+            return false;
+
+        buffer.setSize(numChannels, static_cast<int>(reader->lengthInSamples));
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    }
+
+    juce::File getGoldenFile(const juce::File& folder, const Setting& setting, const juce::String& signal, double sampleRate)
+    {
+        return folder.getChildFile((setting.name + "-" + signal + "-" + juce::String(juce::roundToInt(sampleRate))).replaceCharacter(' ', '_') + ".wav");
+    }
+}
+
+int runGoldenCheck(const GoldenOptions& options)
+{
+    if (options.update)
+        options.folder.createDirectory();
+    else if (! options.folder.isDirectory())
+    {
+        std::cout << "No golden folder at " << options.folder.getFullPathName() << ", create it with --update-golden" << std::endl;
+        return 1;
+    }
+
+    juce::CriticalSection lock;
+    std::atomic<int> numFailed{ 0 }, numExact{ 0 }, numClose{ 0 };
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+
+    auto report = [&lock](const juce::String& message)
+    {
+        const juce::ScopedLock sl(lock);
+        std::cout << message << std::endl;
+    };
+
+    //a job per setting, signal and rate, each one runs every block size against the same reference
+    juce::ThreadPool pool(juce::jmax(1, options.numThreads));
+
+    for (auto& setting : getSettings())
+    {
+        for (auto& signalName : signalNames)
+        {
+            for (auto sampleRate : sampleRates)
+            {
+                pool.addJob([&, sampleRate, signalName, settingPtr = &setting]
+                {
+                    const auto& s = *settingPtr;
+                    const auto name = s.name + " / " + signalName + " / " + juce::String(juce::roundToInt(sampleRate));
+                    const auto file = getGoldenFile(options.folder, s, signalName, sampleRate);
+                    const auto input = makeSignal(signalName, sampleRate);
+
+                    if (options.update)
+                    {
+                        if (! writeGolden(file, render(s, input, sampleRate, blockSizes[0]), sampleRate))
+                        {
+                            ++numFailed;
+                            report("FAIL   " + name + ": can't write " + file.getFullPathName());
+                        }
+
+                        return;
+                    }
+
+                    juce::AudioBuffer<float> golden;
+                    if (! readGolden(file, golden) || golden.getNumSamples() != input.getNumSamples())
+                    {
+                        numFailed += blockSizes.size();
+                        report("FAIL   " + name + ": no usable golden file, run with --update-golden");
+                        return;
+                    }
+
+                    for (auto blockSize : blockSizes)
+                    {
+                        auto d = compare(golden, render(s, input, sampleRate, blockSize));
+                        auto detail = name + " / block " + juce::String(blockSize) + ": max error " + juce::String(d.maxError, 9)
+                                    + ", rms error " + juce::String(d.rmsDb, 1) + " dB";
+
+                        if (d.exact)
+                            ++numExact;
+                        else if (! options.requireExact && d.rmsDb <= options.toleranceDb)
+                        {
+                            ++numClose;
+                            report("close  " + detail);
+                        }
+                        else
+                        {
+                            ++numFailed;
+                            report("FAIL   " + detail);
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(10);
+
+    const auto seconds = juce::String((juce::Time::getMillisecondCounterHiRes() - start) / 1000.0, 2);
+
+    if (options.update)
+        std::cout << "Wrote golden files to " << options.folder.getFullPathName() << " in " << seconds << " s" << std::endl;
+    else
+        std::cout << numExact.load() << " exact, " << numClose.load() << " within " << juce::String(options.toleranceDb, 1) << " dB, "
+                  << numFailed.load() << " failed in " << seconds << " s" << std::endl;
+
+    return numFailed.load();
+}
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    GoldenCheck.h
+    Created: 17 Oct 2026 11:26:08pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Golden output check. Renders a fixed set of synthetic signals (sines, a sweep, impulses, noise) through
+//BitCrusherAudioProcessor for a grid of settings, sample rates and block sizes, and compares the result with
+//the files stored in the golden folder. Everything is deterministic, dither included, so an unchanged build
+//matches them bit for bit. A case passes when it's bit exact, or when the rms of the difference is under
+//the tolerance, unless exact matches were asked for.
+//--update renders the references at the reference block size and overwrites the folder.
+struct GoldenOptions
+{
+    juce::File folder;
+    bool update = false;
+    bool requireExact = false;
+    double toleranceDb = -60.0;
+    int numThreads = juce::SystemStats::getNumCpus();
+};
+
+//returns the number of cases that failed, or couldn't be written with --update
+int runGoldenCheck(const GoldenOptions& options);
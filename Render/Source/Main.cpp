@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Offline renderer: streams audio files through BitCrusherAudioProcessor
+    without a host or an editor, one processor per worker thread.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "GoldenCheck.h"
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::File outputDir;
+        juce::String outputFormat;
+        juce::String suffix{ "_crushed" };
+        juce::MemoryBlock state;
+        juce::StringPairArray parameters;
+        int blockSize = 8192;
+        int numThreads = juce::SystemStats::getNumCpus();
+    };
+
+    juce::CriticalSection consoleLock;
+
+    void print(const juce::String& message)
+    {
+        const juce::ScopedLock sl(consoleLock);
+        std::cout << message << std::endl;
+    }
+
+    void printUsage()
+    {
+        print("Usage: BitCrusherRender [options] <files or folders...>\n"
+              "\n"
+              "  --out <folder>          write results here (default: next to the input)\n"
+              "  --format <wav|aiff|flac> output format (default: same as the input)\n"
+              "  --suffix <text>         appended to output names (default: _crushed)\n"
+              "  --set <id>=<value>      set a parameter, e.g. --set bitDepth=6 --set oversampling=4x\n"
+              "  --state <file>          load a state blob saved by the plugin or by --save-state\n"
+              "  --save-state <file>     write the resulting state blob and exit\n"
+              "  --block <samples>       processing block size (default: 8192)\n"
+              "  --threads <n>           worker threads (default: number of cpus)\n"
+              "\n"
+              "Regression check, renders built in test signals instead of files:\n"
+              "  --golden <folder>       compare against the golden files in the folder, exits 1 on any failure\n"
+              "  --update-golden         write new golden files to the folder instead\n"
+              "  --tolerance <dB>        rms difference that still passes (default: -60)\n"
+              "  --exact                 only bit exact output passes");
+    }
+
+    //sets up a processor exactly like a host would before rendering starts
+    bool configureProcessor(BitCrusherAudioProcessor& processor, const RenderSettings& settings)
+    {
+        if (settings.state.getSize() > 0)
+            processor.setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+
+        for (auto& id : settings.parameters.getAllKeys())
+        {
+            auto* param = processor.apvts.getParameter(id);
+            if (param == nullptr)
+            {
+                print("Unknown parameter: " + id);
+                return false;
+            }
+
+            param->setValueNotifyingHost(param->getValueForText(settings.parameters[id]));
+        }
+
+        processor.setNonRealtime(true);
+        return true;
+    }
+
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker(const juce::Array<juce::File>& filesToRender, std::atomic<int>& next, std::atomic<int>& failed, const RenderSettings& renderSettings)
+            : juce::Thread("BitCrusher render"), files(filesToRender), nextFile(next), numFailed(failed), settings(renderSettings)
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        bool prepare()
+        {
+            return configureProcessor(processor, settings);
+        }
+
+        void run() override
+        {
+            //workers pull files off a shared counter so long files don't leave other cores idle
+            for (auto index = nextFile++; index < files.size() && ! threadShouldExit(); index = nextFile++)
+            {
+                juce::String error;
+                auto start = juce::Time::getMillisecondCounterHiRes();
+
+                if (renderFile(files.getReference(index), error))
+                    print("Rendered " + files.getReference(index).getFileName() + " (" + juce::String(juce::Time::getMillisecondCounterHiRes() - start, 0) + " ms)");
+                else
+                {
+                    ++numFailed;
+                    print("Failed " + files.getReference(index).getFullPathName() + ": " + error);
+                }
+            }
+        }
+
+    private:
+        const juce::Array<juce::File>& files;
+        std::atomic<int>& nextFile;
+        std::atomic<int>& numFailed;
+        const RenderSettings& settings;
+
+        BitCrusherAudioProcessor processor;
+        juce::AudioFormatManager formatManager;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+
+        juce::File getOutputFile(const juce::File& input, juce::AudioFormat& format) const
+        {
+            auto dir = settings.outputDir == juce::File() ? input.getParentDirectory() : settings.outputDir;
+            auto extension = format.getFileExtensions()[0];
+            return dir.getChildFile(input.getFileNameWithoutExtension() + settings.suffix + extension);
+        }
+
+        juce::AudioFormat* getOutputFormat(const juce::File& input)
+        {
+            if (settings.outputFormat.isNotEmpty())
+                return formatManager.findFormatForFileExtension(settings.outputFormat);
+
+            return formatManager.findFormatForFileExtension(input.getFileExtension());
+        }
+
+        bool renderFile(const juce::File& input, juce::String& error)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+            if (reader == nullptr)
+            {
+                error = "not a readable audio file";
+                return false;
+            }
+
+            auto numChannels = static_cast<int>(reader->numChannels);
+            auto layout = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+            BitCrusherAudioProcessor::BusesLayout buses;
+            buses.inputBuses.add(layout);
+            buses.outputBuses.add(layout);
+
+            if (! processor.setBusesLayout(buses))
+            {
+                error = juce::String(numChannels) + " channels are not supported";
+                return false;
+            }
+
+            auto* format = getOutputFormat(input);
+            if (format == nullptr)
+            {
+                error = "no writer for the requested output format";
+                return false;
+            }
+
+            //keep the source bit depth when the output format can store it, otherwise take the deepest it can
+            auto depths = format->getPossibleBitDepths();
+            auto bitsPerSample = depths.contains(static_cast<int>(reader->bitsPerSample)) ? static_cast<int>(reader->bitsPerSample) : depths.getLast();
+
+            auto outputFile = getOutputFile(input, *format);
+            outputFile.deleteFile();
+
+            std::unique_ptr<juce::OutputStream> stream(outputFile.createOutputStream());
+            if (stream == nullptr)
+            {
+                error = "can't write " + outputFile.getFullPathName();
+                return false;
+            }
+
+            std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), reader->sampleRate, static_cast<unsigned int>(numChannels),
+                                                                                     bitsPerSample, reader->metadataValues, 0));
+            if (writer == nullptr)
+            {
+                error = "the output format can't take this sample rate or channel count";
+                return false;
+            }
+
+            stream.release(); //the writer owns the stream now
+
+            processor.setRateAndBufferSizeDetails(reader->sampleRate, settings.blockSize);
+            processor.prepareToPlay(reader->sampleRate, settings.blockSize);
+            buffer.setSize(numChannels, settings.blockSize);
+
+            //run past the end by the plugin latency and drop that much from the start, so the output lines up with the input
+            auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+            auto totalSamples = reader->lengthInSamples + latency;
+            auto toSkip = latency;
+
+            for (juce::int64 pos = 0; pos < totalSamples; pos += settings.blockSize)
+            {
+                auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(settings.blockSize), totalSamples - pos));
+
+                buffer.setSize(numChannels, numSamples, false, false, true);
+                reader->read(&buffer, 0, numSamples, pos, true, true);
+
+                processor.processBlock(buffer, midi);
+
+                auto skipped = static_cast<int>(juce::jmin(toSkip, static_cast<juce::int64>(numSamples)));
+                toSkip -= skipped;
+
+                if (skipped < numSamples && ! writer->writeFromAudioSampleBuffer(buffer, skipped, numSamples - skipped))
+                {
+                    error = "write failed";
+                    processor.releaseResources();
+                    return false;
+                }
+            }
+
+            processor.releaseResources();
+            return true;
+        }
+    };
+
+    juce::Array<juce::File> collectFiles(const juce::StringArray& paths)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        auto wildcard = formatManager.getWildcardForAllFormats();
+
+        juce::Array<juce::File> files;
+        for (auto& path : paths)
+        {
+            auto file = juce::File::getCurrentWorkingDirectory().getChildFile(path);
+
+            if (file.isDirectory())
+                files.addArray(file.findChildFiles(juce::File::findFiles, false, wildcard));
+            else if (file.existsAsFile())
+                files.add(file);
+            else
+                print("Skipping missing " + path);
+        }
+
+        return files;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    RenderSettings settings;
+    juce::StringArray inputs;
+    juce::File saveStateFile;
+    GoldenOptions golden;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto& arg = args.getReference(i);
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+        else if (arg == "--out" && hasValue)
+            settings.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if (arg == "--format" && hasValue)
+            settings.outputFormat = "." + args[++i].trimCharactersAtStart(".");
+        else if (arg == "--suffix" && hasValue)
+            settings.suffix = args[++i];
+        else if (arg == "--set" && hasValue)
+        {
+            auto assignment = args[++i];
+            settings.parameters.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                    assignment.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+        else if (arg == "--state" && hasValue)
+        {
+            if (! juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]).loadFileAsData(settings.state))
+            {
+                print("Can't read state file " + args[i]);
+                return 1;
+            }
+        }
+        else if (arg == "--save-state" && hasValue)
+            saveStateFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if (arg == "--block" && hasValue)
+            settings.blockSize = juce::jmax(16, args[++i].getIntValue());
+        else if (arg == "--threads" && hasValue)
+            settings.numThreads = golden.numThreads = juce::jmax(1, args[++i].getIntValue());
+        else if (arg == "--golden" && hasValue)
+            golden.folder = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+        else if (arg == "--update-golden")
+            golden.update = true;
+        else if (arg == "--tolerance" && hasValue)
+            golden.toleranceDb = args[++i].getDoubleValue();
+        else if (arg == "--exact")
+            golden.requireExact = true;
+        else if (arg.startsWith("--"))
+        {
+            print("Unknown option " + arg);
+            printUsage();
+            return 1;
+        }
+        else
+            inputs.add(arg);
+    }
+
+    if (golden.folder != juce::File())
+        return runGoldenCheck(golden) == 0 ? 0 : 1;
+
+    if (saveStateFile != juce::File())
+    {
+        BitCrusherAudioProcessor processor;
+        if (! configureProcessor(processor, settings))
+            return 1;
+
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+        return saveStateFile.replaceWithData(state.getData(), state.getSize()) ? 0 : 1;
+    }
+
+    auto files = collectFiles(inputs);
+    if (files.isEmpty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (settings.outputDir != juce::File())
+        settings.outputDir.createDirectory();
+
+    std::atomic<int> nextFile{ 0 };
+    std::atomic<int> numFailed{ 0 };
+
+    //processors are built here on the main thread, each worker then owns one for its whole run
+    juce::OwnedArray<RenderWorker> workers;
+    for (int i = 0; i < juce::jmin(settings.numThreads, files.size()); ++i)
+    {
+        auto* worker = workers.add(new RenderWorker(files, nextFile, numFailed, settings));
+        if (! worker->prepare())
+            return 1;
+    }
+
+    auto start = juce::Time::getMillisecondCounterHiRes();
+
+    for (auto* worker : workers)
+        worker->startThread();
+
+    for (auto* worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    print("Rendered " + juce::String(files.size() - numFailed.load()) + " of " + juce::String(files.size()) + " files in "
+          + juce::String((juce::Time::getMillisecondCounterHiRes() - start) / 1000.0, 2) + " s on " + juce::String(workers.size()) + " threads");
+
+    return numFailed.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    AllocationGuard.cpp
+    Created: 17 Oct 2026 11:40:27am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "AllocationGuard.h"
+
+#if BITCRUSHER_ALLOCATION_GUARD
+#include <cstdlib>
+#include <new>
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+namespace
+{
+    thread_local bool allocationGuardArmed = false;
+
+    void checkAllocation() noexcept
+    {
+        if (allocationGuardArmed)
+        {
+            //disarm first, the assertion's own logging is allowed to allocate
+            allocationGuardArmed = false;
+            jassertfalse; //something on the audio thread touched the heap, check the call stack
+        }
+    }
+
+    void* guardedAllocate(std::size_t size) noexcept
+    {
+        checkAllocation();
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    //frees count too, handing memory back can take the same locks as asking for it
+    void guardedFree(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+            checkAllocation();
+
+        std::free(ptr);
+    }
+
+    //over-aligned types (alignas(32) simd members and the like) come through the std::align_val_t overloads,
+    //those need their own allocator and have to be freed with the matching call
+    void* guardedAllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        checkAllocation();
+
+        const auto align = juce::jmax(static_cast<std::size_t>(alignment), sizeof(void*));
+        size = size == 0 ? 1 : size;
+
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, align);
+       #else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+       #endif
+    }
+
+    void guardedFreeAligned(void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+            checkAllocation();
+
+       #if JUCE_WINDOWS
+        _aligned_free(ptr);
+       #else
+        std::free(ptr);
+       #endif
+    }
+}
+
+ScopedAllocationGuard::ScopedAllocationGuard() noexcept
+    : wasArmed(allocationGuardArmed)
+{
+    allocationGuardArmed = true;
+}
+
+ScopedAllocationGuard::~ScopedAllocationGuard() noexcept
+{
+    allocationGuardArmed = wasArmed;
+}
+
+void* operator new(std::size_t size)
+{
+    if (auto* ptr = guardedAllocate(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (auto* ptr = guardedAllocate(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept    { return guardedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept  { return guardedAllocate(size); }
+
+void operator delete(void* ptr) noexcept                                { guardedFree(ptr); }
+void operator delete[](void* ptr) noexcept                              { guardedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept                   { guardedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept                 { guardedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept         { guardedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept       { guardedFree(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto* ptr = guardedAllocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (auto* ptr = guardedAllocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept    { return guardedAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept  { return guardedAllocateAligned(size, alignment); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept                                  { guardedFreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept                                { guardedFreeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept                     { guardedFreeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept                   { guardedFreeAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept           { guardedFreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept         { guardedFreeAligned(ptr); }
+#endif
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    AllocationGuard.h
+    Created: 17 Oct 2026 11:40:27am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Debug builds swap in a global operator new/delete that asserts whenever something allocates
+//while a ScopedAllocationGuard is alive on the same thread. Release builds get an empty guard.
+#ifndef BITCRUSHER_ALLOCATION_GUARD
+ #if JUCE_DEBUG
+  #define BITCRUSHER_ALLOCATION_GUARD 1
+ #else
+  #define BITCRUSHER_ALLOCATION_GUARD 0
+ #endif
+#endif
+
+#if BITCRUSHER_ALLOCATION_GUARD
+struct ScopedAllocationGuard
+{
+    ScopedAllocationGuard() noexcept;
+    ~ScopedAllocationGuard() noexcept;
+
+private:
+    bool wasArmed;
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedAllocationGuard)
+};
+#else
+struct ScopedAllocationGuard
+{
+    ScopedAllocationGuard() noexcept {}
+};
+#endif
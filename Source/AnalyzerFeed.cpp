@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    AnalyzerFeed.cpp
+    Created: 18 Oct 2026 12:41:37am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "AnalyzerFeed.h"
+
+AnalyzerFeed::AnalyzerFeed()
+{
+    //allocated once here, prepare() can run while the analyzer thread is reading so it never touches the fifos
+    for (auto& f : fifos)
+        f.data.resize(static_cast<size_t>(fifoSize));
+}
+
+void AnalyzerFeed::prepare(double newSampleRate)
+{
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void AnalyzerFeed::push(Point point, const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+{
+    auto& f = fifos[static_cast<size_t>(point)];
+    const auto gain = static_cast<SampleType>(1) / static_cast<SampleType>(juce::jmax(1, numChannels));
+
+    int start1, size1, start2, size2;
+    f.fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    //the sum goes straight into the fifo, at most two runs where it wraps. channel by channel so the loops stay simple enough to vectorise
+    auto sumInto = [&](int destStart, int size, int srcStart)
+    {
+        if (size <= 0)
+            return;
+
+        auto* dest = f.data.data() + destStart;
+        std::fill_n(dest, size, 0.f);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* src = buffer.getReadPointer(ch, srcStart);
+            for (int s = 0; s < size; ++s)
+                dest[s] += static_cast<float>(src[s] * gain);
+        }
+    };
+
+    sumInto(start1, size1, 0);
+    sumInto(start2, size2, size1);
+    f.fifo.finishedWrite(size1 + size2);
+}
+
+int AnalyzerFeed::read(Point point, float* dest, int maxSamples)
+{
+    auto& f = fifos[static_cast<size_t>(point)];
+
+    int start1, size1, start2, size2;
+    f.fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+    std::copy_n(f.data.data() + start1, size1, dest);
+    std::copy_n(f.data.data() + start2, size2, dest + size1);
+
+    f.fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+void AnalyzerFeed::discard(Point point)
+{
+    auto& f = fifos[static_cast<size_t>(point)];
+    f.fifo.finishedRead(f.fifo.getNumReady());
+}
+
+template void AnalyzerFeed::push<float>(Point, const juce::AudioBuffer<float>&, int, int);
+template void AnalyzerFeed::push<double>(Point, const juce::AudioBuffer<double>&, int, int);
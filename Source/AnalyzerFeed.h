@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    AnalyzerFeed.h
+    Created: 18 Oct 2026 12:41:37am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//The audio side of the spectrum and scope. The processor pushes a mono sum of its input and output into
+//one single producer single consumer fifo each, the analyzer thread in the editor drains them.
+//Pushing never waits: whatever doesn't fit in a full fifo is dropped. Like the meters it only runs while a consumer is attached,
+//with the editor closed the audio thread doesn't touch any of it.
+class AnalyzerFeed
+{
+public:
+    enum Point { input, output, numPoints };
+
+    //a bit over a third of a second at 96k, the reader drains it many times faster than that
+    static constexpr int fifoSize = 1 << 15;
+
+    AnalyzerFeed();
+
+    //============================================================================== audio side
+    void prepare(double sampleRate);
+
+    bool isActive() const { return numConsumers.load(std::memory_order_relaxed) > 0; }
+
+    template <typename SampleType>
+    void push(Point point, const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples);
+
+    //============================================================================== reader side
+    //only one thread may read
+    int read(Point point, float* dest, int maxSamples);
+    void discard(Point point);
+
+    double getSampleRate() const { return sampleRate.load(std::memory_order_relaxed); }
+
+    //the feed only runs while at least one of these is alive
+    struct ScopedConsumer
+    {
+        explicit ScopedConsumer(AnalyzerFeed& f) : feed(f) { ++feed.numConsumers; }
+        ~ScopedConsumer() { --feed.numConsumers; }
+
+    private:
+        AnalyzerFeed& feed;
+        JUCE_DECLARE_NON_COPYABLE(ScopedConsumer)
+    };
+
+private:
+    struct Fifo
+    {
+        juce::AbstractFifo fifo{ fifoSize };
+        std::vector<float> data;
+    };
+
+    std::array<Fifo, numPoints> fifos;
+    std::atomic<int> numConsumers{ 0 };
+    std::atomic<double> sampleRate{ 44100.0 };
+};
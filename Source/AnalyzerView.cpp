@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+    AnalyzerView.cpp
+    Created: 18 Oct 2026 12:58:10am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "AnalyzerView.h"
+
+AnalyzerView::AnalyzerView(AnalyzerFeed& f) : feed(f), consumer(f)
+{
+    setInterceptsMouseClicks(false, false);
+
+    worker.startThread();
+    startTimerHz(30);
+}
+
+AnalyzerView::~AnalyzerView()
+{
+    stopTimer();
+    worker.stopThread(1000);
+}
+
+void AnalyzerView::timerCallback()
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(pathLock);
+        if (! pathsChanged)
+            return;
+
+        std::swap(shown, latest);
+        pathsChanged = false;
+    }
+
+    repaint();
+}
+
+void AnalyzerView::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(.6f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.f);
+
+    auto bounds = getLocalBounds().toFloat().reduced(4.f);
+    auto spectrumArea = bounds.removeFromLeft(bounds.getWidth() * .65f);
+    bounds.removeFromLeft(4.f);
+    auto scopeArea = bounds;
+
+    //a line per decade on the spectrum, the zero line on the scope
+    g.setColour(juce::Colours::whitesmoke.withAlpha(.15f));
+    for (auto frequency : { 100.f, 1000.f, 10000.f })
+    {
+        auto x = spectrumArea.getX() + spectrumArea.getWidth() * std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+        g.drawVerticalLine(juce::roundToInt(x), spectrumArea.getY(), spectrumArea.getBottom());
+    }
+
+    g.drawHorizontalLine(juce::roundToInt(scopeArea.getCentreY()), scopeArea.getX(), scopeArea.getRight());
+
+    //the transform goes on before the stroke, so the lines stay the same width at any size
+    const auto toSpectrum = juce::AffineTransform::scale(spectrumArea.getWidth(), spectrumArea.getHeight()).translated(spectrumArea.getPosition());
+    const auto toScope = juce::AffineTransform::scale(scopeArea.getWidth(), scopeArea.getHeight()).translated(scopeArea.getPosition());
+
+    g.setColour(juce::Colours::whitesmoke.withAlpha(.5f));
+    g.strokePath(shown.spectrum[AnalyzerFeed::input], juce::PathStrokeType(1.f), toSpectrum);
+
+    g.setColour(juce::Colour(186u, 34u, 34u).brighter(.4f));
+    g.strokePath(shown.spectrum[AnalyzerFeed::output], juce::PathStrokeType(1.5f), toSpectrum);
+
+    g.setColour(juce::Colour(64u, 194u, 230u));
+    g.strokePath(shown.scope, juce::PathStrokeType(1.f), toScope);
+}
+
+//==============================================================================
+AnalyzerView::Worker::Worker(AnalyzerView& v) : juce::Thread("BitCrusher analyzer"), view(v)
+{
+    for (auto& h : history)
+        h.assign(static_cast<size_t>(historySize), 0.f);
+
+    for (auto& l : levels)
+        l.assign(static_cast<size_t>(spectrumColumns), minDb);
+
+    incoming.resize(static_cast<size_t>(AnalyzerFeed::fifoSize));
+    fftData.resize(static_cast<size_t>(fftSize * 2));
+}
+
+void AnalyzerView::Worker::run()
+{
+    //whatever piled up before the view opened is stale
+    for (int point = 0; point < AnalyzerFeed::numPoints; ++point)
+        view.feed.discard(static_cast<AnalyzerFeed::Point>(point));
+
+    constexpr int intervalMs = 33;
+
+    //the spectrum falls back at 30 dB a second
+    constexpr float fallDb = 30.f * static_cast<float>(intervalMs) / 1000.f;
+
+    while (! threadShouldExit())
+    {
+        const auto start = juce::Time::getMillisecondCounter();
+
+        auto changed = false;
+        for (int point = 0; point < AnalyzerFeed::numPoints; ++point)
+            changed = drain(static_cast<AnalyzerFeed::Point>(point)) || changed;
+
+        if (changed)
+        {
+            const auto sampleRate = view.feed.getSampleRate();
+            Paths paths;
+
+            for (int point = 0; point < AnalyzerFeed::numPoints; ++point)
+            {
+                analyse(static_cast<AnalyzerFeed::Point>(point), sampleRate, fallDb);
+                paths.spectrum[static_cast<size_t>(point)] = makeSpectrumPath(levels[static_cast<size_t>(point)]);
+            }
+
+            paths.scope = makeScopePath(sampleRate);
+
+            const juce::SpinLock::ScopedLockType lock(view.pathLock);
+            std::swap(view.latest, paths);
+            view.pathsChanged = true;
+        }
+
+        const auto elapsed = static_cast<int>(juce::Time::getMillisecondCounter() - start);
+        wait(juce::jmax(1, intervalMs - elapsed));
+    }
+}
+
+bool AnalyzerView::Worker::drain(AnalyzerFeed::Point point)
+{
+    auto& h = history[static_cast<size_t>(point)];
+    auto total = 0;
+
+    for (;;)
+    {
+        const auto n = view.feed.read(point, incoming.data(), static_cast<int>(incoming.size()));
+        if (n == 0)
+            break;
+
+        total += n;
+
+        //slide the history along and put the new samples on the end
+        if (n >= historySize)
+        {
+            std::copy_n(incoming.data() + n - historySize, historySize, h.data());
+        }
+        else
+        {
+            std::move(h.begin() + n, h.end(), h.begin());
+            std::copy_n(incoming.data(), n, h.data() + historySize - n);
+        }
+    }
+
+    return total > 0;
+}
+
+void AnalyzerView::Worker::analyse(AnalyzerFeed::Point point, double sampleRate, float fallDb)
+{
+    const auto& h = history[static_cast<size_t>(point)];
+    auto& columns = levels[static_cast<size_t>(point)];
+
+    std::copy(h.end() - fftSize, h.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.f);
+
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    //a full scale sine reads 0 dB, the hann window takes half of its amplitude
+    const auto gain = 4.f / static_cast<float>(fftSize);
+    const auto binsPerHz = static_cast<float>(fftSize / sampleRate);
+    const auto lastBin = static_cast<float>(fftSize / 2);
+    const auto ratio = maxFrequency / minFrequency;
+
+    //each column takes the loudest bin under it, down low where a column is narrower than a bin it interpolates
+    for (int c = 0; c < spectrumColumns; ++c)
+    {
+        auto low = juce::jmin(lastBin, minFrequency * std::pow(ratio, static_cast<float>(c) / spectrumColumns) * binsPerHz);
+        auto high = juce::jmin(lastBin, minFrequency * std::pow(ratio, static_cast<float>(c + 1) / spectrumColumns) * binsPerHz);
+        auto magnitude = 0.f;
+
+        if (static_cast<int>(high) > static_cast<int>(low))
+        {
+            for (auto bin = static_cast<int>(low) + 1; bin <= static_cast<int>(high); ++bin)
+                magnitude = juce::jmax(magnitude, fftData[static_cast<size_t>(bin)]);
+        }
+        else
+        {
+            auto bin = static_cast<int>(low);
+            auto next = juce::jmin(bin + 1, fftSize / 2);
+            magnitude = juce::jmap(low - static_cast<float>(bin), fftData[static_cast<size_t>(bin)], fftData[static_cast<size_t>(next)]);
+        }
+
+        auto db = juce::Decibels::gainToDecibels(magnitude * gain, minDb);
+        auto& level = columns[static_cast<size_t>(c)];
+        level = juce::jmax(db, level - fallDb);
+    }
+}
+
+juce::Path AnalyzerView::Worker::makeSpectrumPath(const std::vector<float>& columns) const
+{
+    juce::Path path;
+
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+        auto x = static_cast<float>(c) / static_cast<float>(columns.size() - 1);
+        auto y = juce::jlimit(0.f, 1.f, columns[c] / minDb);
+
+        if (c == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    return path;
+}
+
+juce::Path AnalyzerView::Worker::makeScopePath(double sampleRate) const
+{
+    const auto& h = history[AnalyzerFeed::output];
+    const auto length = juce::jlimit(scopeColumns, historySize / 2, juce::roundToInt(sampleRate * scopeSeconds));
+
+    //the newest rising zero crossing that still has a whole window after it
+    auto start = historySize - length;
+    for (auto i = historySize - length; i > historySize - length * 2; --i)
+    {
+        if (h[static_cast<size_t>(i - 1)] < 0.f && h[static_cast<size_t>(i)] >= 0.f)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    //every column gets the lowest and highest sample that falls in it, so nothing disappears between columns
+    juce::Path path;
+
+    for (int c = 0; c < scopeColumns; ++c)
+    {
+        const auto first = start + c * length / scopeColumns;
+        const auto last = start + (c + 1) * length / scopeColumns;
+        auto range = juce::FloatVectorOperations::findMinAndMax(h.data() + first, last - first);
+
+        auto x = static_cast<float>(c) / static_cast<float>(scopeColumns - 1);
+        auto top = juce::jlimit(0.f, 1.f, .5f - .5f * range.getEnd());
+        auto bottom = juce::jlimit(0.f, 1.f, .5f - .5f * range.getStart());
+
+        if (c == 0)
+            path.startNewSubPath(x, top);
+        else
+            path.lineTo(x, top);
+
+        if (bottom != top)
+            path.lineTo(x, bottom);
+    }
+
+    return path;
+}
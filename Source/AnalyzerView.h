@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    AnalyzerView.h
+    Created: 18 Oct 2026 12:58:10am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "AnalyzerFeed.h"
+
+//Input and output spectrum on the left, a scope of the output on the right.
+//A background thread drains the feed, runs the fft, squeezes everything down to one value per column
+//and builds the paths. The message thread only swaps the latest paths in and strokes them.
+//The paths are built in a unit square, paint() stretches them to whatever size the view has.
+class AnalyzerView : public juce::Component, private juce::Timer
+{
+public:
+    explicit AnalyzerView(AnalyzerFeed& f);
+    ~AnalyzerView() override;
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+
+    //the fft takes the newest fftSize samples, the scope needs the extra to look back for its trigger
+    static constexpr int historySize = fftSize * 2;
+
+    //columns the spectrum and scope are decimated to
+    static constexpr int spectrumColumns = 256;
+    static constexpr int scopeColumns = 192;
+
+    static constexpr float minFrequency = 20.f, maxFrequency = 20000.f;
+    static constexpr float minDb = -90.f;
+
+    //the scope shows this much of the output, it starts on a rising zero crossing so a steady tone stands still
+    static constexpr double scopeSeconds = .02;
+
+    struct Paths
+    {
+        std::array<juce::Path, AnalyzerFeed::numPoints> spectrum;
+        juce::Path scope;
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(AnalyzerView& v);
+        void run() override;
+
+    private:
+        AnalyzerView& view;
+
+        juce::dsp::FFT fft{ fftOrder };
+        juce::dsp::WindowingFunction<float> window{ static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false };
+
+        //the newest historySize samples of each point, oldest first
+        std::array<std::vector<float>, AnalyzerFeed::numPoints> history;
+        std::vector<float> incoming, fftData;
+
+        //the spectra in dB per column, they rise straight away and fall back slowly
+        std::array<std::vector<float>, AnalyzerFeed::numPoints> levels;
+
+        bool drain(AnalyzerFeed::Point point);
+        void analyse(AnalyzerFeed::Point point, double sampleRate, float fallDb);
+        juce::Path makeSpectrumPath(const std::vector<float>& columns) const;
+        juce::Path makeScopePath(double sampleRate) const;
+    };
+
+    AnalyzerFeed& feed;
+    AnalyzerFeed::ScopedConsumer consumer;
+
+    //the worker hands finished paths over here, neither side holds the lock for more than a swap
+    juce::SpinLock pathLock;
+    Paths latest;
+    bool pathsChanged = false;
+
+    //message thread only
+    Paths shown;
+
+    Worker worker{ *this };
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerView)
+};
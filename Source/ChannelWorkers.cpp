@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    ChannelWorkers.cpp
+    Created: 17 Oct 2026 11:58:44pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "ChannelWorkers.h"
+
+ChannelWorkers::~ChannelWorkers()
+{
+    {
+        const std::lock_guard<std::mutex> lock(wakeLock);
+        exiting = true;
+    }
+
+    wake.notify_all();
+
+    for (auto* worker : workers)
+        worker->stopThread(-1);
+}
+
+void ChannelWorkers::start()
+{
+    const std::lock_guard<std::mutex> lock(startLock);
+
+    if (isRunning())
+        return;
+
+    //the thread that submits a batch works on it as well, so one less than the core count keeps every core busy
+    const auto numWorkers = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new Worker(*this))->startThread();
+
+    running.store(true, std::memory_order_release);
+}
+
+bool ChannelWorkers::work(Batch& batch)
+{
+    auto didWork = false;
+
+    for (auto index = batch.next.fetch_add(1); index < batch.numTasks; index = batch.next.fetch_add(1))
+    {
+        batch.call(batch.context, index);
+        batch.done.fetch_add(1, std::memory_order_release);
+        didWork = true;
+    }
+
+    return didWork;
+}
+
+void ChannelWorkers::run(int numTasks, void (*call)(void*, int), void* context)
+{
+    if (numTasks <= 0)
+        return;
+
+    Batch* batch = nullptr;
+
+    if (isRunning() && numTasks > 1)
+    {
+        for (auto& b : batches)
+        {
+            auto expected = false;
+            if (b.owned.compare_exchange_strong(expected, true))
+            {
+                batch = &b;
+                break;
+            }
+        }
+    }
+
+    if (batch == nullptr)
+    {
+        for (int i = 0; i < numTasks; ++i)
+            call(context, i);
+
+        return;
+    }
+
+    //everything is in place before the batch goes active, the workers only read it after seeing that
+    batch->numTasks = numTasks;
+    batch->call = call;
+    batch->context = context;
+    batch->next.store(0);
+    batch->done.store(0);
+    batch->active.store(true);
+
+    {
+        const std::lock_guard<std::mutex> lock(wakeLock);
+        ++generation;
+    }
+
+    wake.notify_all();
+
+    work(*batch);
+
+    //the tasks are whole channel groups of a big block, the wait is short and only ever offline
+    while (batch->done.load(std::memory_order_acquire) < numTasks)
+        std::this_thread::yield();
+
+    //a worker may still be looking at the batch, it goes back to the pool once they've all let go
+    batch->active.store(false);
+    while (batch->users.load() > 0)
+        std::this_thread::yield();
+
+    batch->owned.store(false);
+}
+
+void ChannelWorkers::workerLoop()
+{
+    //denormals are per thread, the audio thread's setting doesn't reach the workers
+    const juce::ScopedNoDenormals noDenormals;
+    juce::uint64 seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeLock);
+            wake.wait(lock, [&] { return exiting || generation != seen; });
+
+            if (exiting)
+                return;
+
+            seen = generation;
+        }
+
+        //keep sweeping the batches until a whole pass finds nothing left to take
+        for (auto didWork = true; didWork;)
+        {
+            didWork = false;
+
+            for (auto& batch : batches)
+            {
+                batch.users.fetch_add(1);
+
+                if (batch.active.load())
+                    didWork = work(batch) || didWork;
+
+                batch.users.fetch_sub(1);
+            }
+        }
+    }
+}
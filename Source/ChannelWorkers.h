@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    ChannelWorkers.h
+    Created: 17 Oct 2026 11:58:44pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <mutex>
+
+//Worker threads for offline renders, shared by every instance in the process through juce::SharedResourcePointer.
+//The threads are only started by the first instance that asks for them and then stay parked until there's work,
+//nothing gets created per block. A caller hands over a batch of tasks and works through it alongside the workers,
+//every thread grabs the next task off the batch's counter, so whoever is free takes the next one.
+//Several instances can run batches at the same time, the workers pick from all of them.
+//Not for realtime use: submitting takes a lock and the caller waits for the slowest task.
+class ChannelWorkers
+{
+public:
+    ChannelWorkers() = default;
+    ~ChannelWorkers();
+
+    //call from prepareToPlay, never from the audio thread
+    void start();
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    //runs task(0) .. task(numTasks - 1) and returns when they're all done. without workers,
+    //or with every batch slot already taken, the tasks just run here one after another
+    template <typename Task>
+    void parallelFor(int numTasks, Task&& task)
+    {
+        using TaskType = std::remove_reference_t<Task>;
+        run(numTasks, [](void* context, int index) { (*static_cast<TaskType*>(context))(index); }, &task);
+    }
+
+private:
+    struct Batch
+    {
+        std::atomic<bool> owned{ false }, active{ false };
+        std::atomic<int> users{ 0 };
+        std::atomic<int> next{ 0 }, done{ 0 };
+        int numTasks = 0;
+        void (*call)(void*, int) = nullptr;
+        void* context = nullptr;
+    };
+
+    struct Worker : public juce::Thread
+    {
+        explicit Worker(ChannelWorkers& w) : juce::Thread("BitCrusher channel worker"), owner(w) {}
+        void run() override { owner.workerLoop(); }
+
+        ChannelWorkers& owner;
+    };
+
+    static constexpr int maxBatches = 16;
+    std::array<Batch, maxBatches> batches;
+
+    juce::OwnedArray<Worker> workers;
+    std::atomic<bool> running{ false };
+    std::mutex startLock;
+
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    juce::uint64 generation = 0;
+    bool exiting = false;
+
+    void run(int numTasks, void (*call)(void*, int), void* context);
+    static bool work(Batch& batch);
+    void workerLoop();
+
+    JUCE_DECLARE_NON_COPYABLE(ChannelWorkers)
+};
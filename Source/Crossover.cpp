@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    Crossover.cpp
+    Created: 18 Oct 2026 2:41:19am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "Crossover.h"
+
+//butterworth damping, two of these in a row are the linkwitz-riley slope and the low and high sides sum to an allpass
+static constexpr double butterworthK = juce::MathConstants<double>::sqrt2;
+
+//one sample through an svf section, the same form as the filter bank's. hands back the low pass, the band pass comes out in bp
+template <typename SampleType>
+static SampleType tick(SampleType x, SampleType* s, const SampleType* c, SampleType& bp)
+{
+    auto v3 = x - s[1];
+    auto v1 = c[0] * s[0] + c[1] * v3;
+    auto v2 = s[1] + c[1] * s[0] + c[2] * v3;
+    s[0] = v1 + v1 - s[0];
+    s[1] = v2 + v2 - s[1];
+    bp = v1;
+    return v2;
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::prepare(int numChannels)
+{
+    state.assign(static_cast<size_t>(numChannels * stateSize), SampleType());
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::reset()
+{
+    std::fill(state.begin(), state.end(), SampleType());
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::setParameters(int newNumBands, const float* frequencies, double sampleRate)
+{
+    newNumBands = juce::jlimit(1, maxBands, newNumBands);
+
+    if (newNumBands != numBands)
+    {
+        numBands = newNumBands;
+        lastSampleRate = 0.0;
+        reset();
+    }
+
+    const auto numCrossovers = static_cast<size_t>(numBands - 1);
+    if (sampleRate == lastSampleRate && std::equal(frequencies, frequencies + numCrossovers, lastFrequencies.begin()))
+        return;
+
+    lastSampleRate = sampleRate;
+    std::copy(frequencies, frequencies + numCrossovers, lastFrequencies.begin());
+
+    for (size_t c = 0; c < numCrossovers; ++c)
+    {
+        auto frequency = juce::jlimit(10.0, sampleRate * .49, static_cast<double>(frequencies[c]));
+        auto g = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        auto a1 = 1.0 / (1.0 + g * (g + butterworthK));
+        auto a2 = g * a1;
+        auto a3 = g * a2;
+
+        coefficients[3 * c] = static_cast<SampleType>(a1);
+        coefficients[3 * c + 1] = static_cast<SampleType>(a2);
+        coefficients[3 * c + 2] = static_cast<SampleType>(a3);
+    }
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::split(int channel, const SampleType* src, SampleType* const* bands, int numSamples)
+{
+    jassert(static_cast<size_t>((channel + 1) * stateSize) <= state.size());
+
+    const auto k = static_cast<SampleType>(butterworthK);
+
+    if (numBands == 1)
+    {
+        if (bands[0] != src)
+            std::copy_n(src, numSamples, bands[0]);
+
+        return;
+    }
+
+    //crossover c takes what's left above the last one, the low side is band c and the high side goes on up as band c + 1
+    for (int c = 0; c < numBands - 1; ++c)
+    {
+        const auto* in = c == 0 ? src : bands[c];
+        auto* low = bands[c];
+        auto* high = bands[c + 1];
+        auto* s = state.data() + channel * stateSize + c * statePerCrossover;
+        const auto* coefs = coefficients.data() + 3 * c;
+        SampleType bp;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto x = in[n];
+            auto lp = tick(x, s, coefs, bp);
+            auto hp = x - k * bp - lp;
+
+            low[n] = tick(lp, s + 2, coefs, bp);
+            auto lp2 = tick(hp, s + 4, coefs, bp);
+            high[n] = hp - k * bp - lp2;
+        }
+    }
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::join(int channel, const SampleType* const* bands, SampleType* dest, int numSamples)
+{
+    jassert(static_cast<size_t>((channel + 1) * stateSize) <= state.size());
+
+    const auto twoK = static_cast<SampleType>(2.0 * butterworthK);
+
+    if (dest != bands[0])
+        std::copy_n(bands[0], numSamples, dest);
+
+    //the sum so far has only been through the crossovers below c, the allpass gives it the turn band c and up got from c.
+    //the lowest crossover needs none, everything above it went through its split
+    for (int c = 1; c < numBands - 1; ++c)
+    {
+        const auto* band = bands[c];
+        auto* s = state.data() + channel * stateSize + c * statePerCrossover + 6;
+        const auto* coefs = coefficients.data() + 3 * c;
+        SampleType bp;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto x = dest[n];
+            tick(x, s, coefs, bp);
+            dest[n] = x - twoK * bp + band[n];
+        }
+    }
+
+    if (numBands > 1)
+        juce::FloatVectorOperations::add(dest, bands[numBands - 1], numSamples);
+}
+
+template class Crossover<float>;
+template class Crossover<double>;
@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 18 Oct 2026 2:41:19am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Linkwitz-Riley 4th order band split for the multiband mode. Each crossover is a butterworth section shared by
+//both sides and then one more section per side, all topology preserving svfs like the filter bank.
+//The bands are split off one after the other from the bottom, so a lower band misses the phase turn of every
+//crossover above it. Instead of an allpass per band per crossover, join() walks back up with a running sum and turns
+//the whole sum once at each crossover, the work grows with the band count instead of its square.
+//With every band left alone the output is the input through an allpass, flat at every frequency.
+template <typename SampleType>
+class Crossover
+{
+public:
+    static constexpr int maxBands = 4;
+
+    void prepare(int numChannels);
+    void reset();
+
+    //the frequencies are in Hz, lowest first, numBands - 1 of them. a new band count also clears the state
+    void setParameters(int numBands, const float* frequencies, double sampleRate);
+    int getNumBands() const { return numBands; }
+
+    //bands[b] gets band b of src, lowest first. src may be bands[0]
+    void split(int channel, const SampleType* src, SampleType* const* bands, int numSamples);
+
+    //dest = the bands summed back, dest may be bands[0] but none of the others
+    void join(int channel, const SampleType* const* bands, SampleType* dest, int numSamples);
+
+private:
+    static constexpr int maxCrossovers = maxBands - 1;
+
+    //per crossover: the shared section, the low side, the high side and the allpass join() puts the sum through
+    static constexpr int statePerCrossover = 8;
+    static constexpr int stateSize = maxCrossovers * statePerCrossover;
+
+    //a1, a2, a3 of each crossover's svf, the same for all four of its sections
+    std::array<SampleType, maxCrossovers * 3> coefficients{};
+    std::vector<SampleType> state;
+
+    int numBands{ 1 };
+    std::array<float, maxCrossovers> lastFrequencies{};
+    double lastSampleRate{ 0.0 };
+};
@@ -0,0 +1,583 @@
+/*
+  ==============================================================================
+
+    CrushEngine.cpp
+    Created: 17 Oct 2026 5:48:52pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "CrushEngine.h"
+
+template <typename SampleType>
+void CrushEngine<SampleType>::prepare(double newSampleRate, int maxBlockSize, int newNumChannels, const Settings& settings)
+{
+    sampleRate = newSampleRate;
+    numChannels = static_cast<size_t>(newNumChannels);
+
+    wetBuffer.setSize(newNumChannels, maxBlockSize, false, true, false);
+
+    //per channel state is only ever resized here, a new layout always comes with a new prepare
+    const auto groupSize = numChannels < channelsPerGroup ? size_t(1) : channelsPerGroup;
+    groups.clear();
+    groups.resize((numChannels + groupSize - 1) / groupSize);
+
+    oversamplingLatencies.fill(0);
+
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        auto& group = groups[g];
+        group.firstChannel = g * groupSize;
+        group.numChannels = juce::jmin(groupSize, numChannels - group.firstChannel);
+
+        for (size_t i = 0; i < group.oversamplers.size(); ++i)
+        {
+            //polyphase iir half bands keep the added latency low, integer latency lets it be reported exactly
+            group.oversamplers[i] = std::make_unique<juce::dsp::Oversampling<SampleType>>(group.numChannels, i + 1, juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR, true, true);
+            group.oversamplers[i]->initProcessing(static_cast<size_t>(maxBlockSize));
+            oversamplingLatencies[i + 1] = juce::roundToInt(group.oversamplers[i]->getLatencyInSamples());
+        }
+
+        group.dither.prepare(static_cast<int>(group.numChannels), static_cast<int>(group.firstChannel));
+        group.filterBank.prepare(static_cast<int>(group.numChannels));
+        group.decimators.assign(group.numChannels, Decimator<SampleType>());
+
+        group.crossover.prepare(static_cast<int>(group.numChannels));
+
+        //each band's noise is seeded past the whole bus, so no band repeats another band's or channel's
+        for (size_t b = 0; b < group.bandDithers.size(); ++b)
+        {
+            group.bandDithers[b].prepare(static_cast<int>(group.numChannels), static_cast<int>(group.firstChannel + (b + 1) * numChannels));
+            group.bandFilters[b].prepare(static_cast<int>(group.numChannels));
+            group.bandDecimators[b].assign(group.numChannels, Decimator<SampleType>());
+        }
+    }
+
+    //the same length as the processor's switch fade, the dry moves to the new latency while the wet is faded out
+    dryDelay.prepare(newNumChannels, getMaxLatencySamples(), juce::roundToInt(sampleRate * .01));
+
+    activeOversampling = -1;
+    updateOversampling(settings.oversamplingIndex);
+
+    //ramp times per control, the cutoff gets the quickest so sweeps still track
+    smoothedBitDepth.reset(sampleRate, .05);
+    smoothedBitRate.reset(sampleRate, .05);
+    smoothedCutoff.reset(sampleRate, .03);
+    smoothedResonance.reset(sampleRate, .03);
+    smoothedBitDepth.setCurrentAndTargetValue(settings.bitDepth);
+    smoothedBitRate.setCurrentAndTargetValue(settings.bitRate);
+    smoothedCutoff.setCurrentAndTargetValue(settings.cutoff);
+    smoothedResonance.setCurrentAndTargetValue(settings.resonance);
+
+    for (size_t b = 0; b < bandRamps.size(); ++b)
+    {
+        auto& ramps = bandRamps[b];
+        ramps.bitDepth.reset(sampleRate, .05);
+        ramps.bitRate.reset(sampleRate, .05);
+        ramps.mix.reset(sampleRate, .05);
+        ramps.bitDepth.setCurrentAndTargetValue(settings.bands[b].bitDepth);
+        ramps.bitRate.setCurrentAndTargetValue(settings.bands[b].bitRate);
+        ramps.mix.setCurrentAndTargetValue(settings.bands[b].mix);
+    }
+
+    for (size_t c = 0; c < smoothedCrossovers.size(); ++c)
+    {
+        smoothedCrossovers[c].reset(sampleRate, .05);
+        smoothedCrossovers[c].setCurrentAndTargetValue(settings.crossovers[c]);
+    }
+
+    for (auto& group : groups)
+        updateFilter(group, settings);
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::release()
+{
+    groups.clear();
+    numChannels = 0;
+
+    wetBuffer.setSize(0, 0);
+    dryDelay.prepare(0, 0, 0);
+}
+
+template <typename SampleType>
+juce::dsp::AudioBlock<SampleType> CrushEngine<SampleType>::process(const juce::dsp::AudioBlock<const SampleType>& input, const Settings& settings,
+                                                                   const ModulationBlock* modulation, ChannelWorkers* workers)
+{
+    //hosts must stay under the prepared block size and layout, so this only ever shrinks the view of the buffer
+    jassert(static_cast<int>(input.getNumSamples()) <= wetBuffer.getNumSamples() || wetBuffer.getNumSamples() == 0);
+    jassert(input.getNumChannels() <= numChannels);
+
+    updateOversampling(settings.oversamplingIndex);
+    const auto smoothing = updateTargets(settings, modulation);
+
+    auto wetBlock = juce::dsp::AudioBlock<SampleType>(wetBuffer).getSubsetChannelBlock(0, input.getNumChannels()).getSubBlock(0, input.getNumSamples());
+
+    auto processGroupAt = [&](int index)
+    {
+        auto& group = groups[static_cast<size_t>(index)];
+        if (group.firstChannel >= input.getNumChannels())
+            return;
+
+        const auto groupChannels = juce::jmin(group.numChannels, input.getNumChannels() - group.firstChannel);
+        auto groupOutput = wetBlock.getSubsetChannelBlock(group.firstChannel, groupChannels);
+        processGroup(group, input.getSubsetChannelBlock(group.firstChannel, groupChannels), groupOutput, settings, modulation, smoothing);
+    };
+
+    if (workers != nullptr && groups.size() > 1)
+        workers->parallelFor(static_cast<int>(groups.size()), processGroupAt);
+    else
+        for (int g = 0; g < static_cast<int>(groups.size()); ++g)
+            processGroupAt(g);
+
+    //every group walked its own copy of the ramps, the real ones catch up here
+    if (smoothing)
+        skipRamps(static_cast<int>(input.getNumSamples()));
+
+    return wetBlock;
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::skip(int numInputChannels, int numSamples, const Settings& settings, const ModulationBlock* modulation)
+{
+    jassert(static_cast<size_t>(numInputChannels) <= numChannels);
+
+    updateOversampling(settings.oversamplingIndex);
+    const auto smoothing = updateTargets(settings, modulation);
+    const auto inputChannels = static_cast<size_t>(numInputChannels);
+
+    //the same groups and the same steps process() would have run, just without any samples going through them
+    for (auto& group : groups)
+    {
+        if (group.firstChannel >= inputChannels)
+            continue;
+
+        const auto groupChannels = juce::jmin(group.numChannels, inputChannels - group.firstChannel);
+
+        if (smoothing)
+            forEachStep(static_cast<size_t>(numSamples), settings, modulation, [&](size_t, size_t length, const Settings& end, const Settings& start)
+            {
+                skipGroup(group, groupChannels, static_cast<int>(length), end, start);
+            });
+        else
+            skipGroup(group, groupChannels, numSamples, settings, settings);
+    }
+
+    if (smoothing)
+        skipRamps(numSamples);
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::skipGroup(ChannelGroup& group, size_t groupChannels, int numSamples, const Settings& settings, const Settings& start)
+{
+    //the hold grid and the dither run at the stage rate
+    const auto stageSamples = numSamples << juce::jmax(0, activeOversampling);
+    const auto dithering = settings.ditherType != Dither<SampleType>::off;
+
+    if (settings.numBands > 1)
+    {
+        //only the bands crushBands would have run
+        for (size_t b = 0; b < static_cast<size_t>(settings.numBands); ++b)
+        {
+            if (settings.bands[b].mix == 0.f && start.bands[b].mix == 0.f)
+                continue;
+
+            for (size_t ch = 0; ch < groupChannels; ++ch)
+            {
+                group.bandDecimators[b][ch].setRate(settings.bands[b].bitRate, stageSampleRate);
+                group.bandDecimators[b][ch].skip(stageSamples);
+
+                if (dithering)
+                    group.bandDithers[b].skip(static_cast<int>(ch), stageSamples);
+            }
+        }
+
+        return;
+    }
+
+    for (size_t ch = 0; ch < groupChannels; ++ch)
+    {
+        group.decimators[ch].setRate(settings.bitRate, stageSampleRate);
+        group.decimators[ch].skip(stageSamples);
+
+        if (dithering)
+            group.dither.skip(static_cast<int>(ch), stageSamples);
+    }
+}
+
+template <typename SampleType>
+bool CrushEngine<SampleType>::updateTargets(const Settings& settings, const ModulationBlock*& modulation)
+{
+    smoothedBitDepth.setTargetValue(settings.bitDepth);
+    smoothedBitRate.setTargetValue(settings.bitRate);
+    smoothedCutoff.setTargetValue(settings.cutoff);
+    smoothedResonance.setTargetValue(settings.resonance);
+
+    //the band settings only glide while there's more than one band, with one they just follow the parameters
+    const auto multiband = settings.numBands > 1;
+    auto follow = [multiband](auto& ramp, float value)
+    {
+        if (multiband)
+            ramp.setTargetValue(value);
+        else
+            ramp.setCurrentAndTargetValue(value);
+    };
+
+    for (size_t b = 0; b < bandRamps.size(); ++b)
+    {
+        follow(bandRamps[b].bitDepth, settings.bands[b].bitDepth);
+        follow(bandRamps[b].bitRate, settings.bands[b].bitRate);
+        follow(bandRamps[b].mix, settings.bands[b].mix);
+    }
+
+    for (size_t c = 0; c < smoothedCrossovers.size(); ++c)
+        follow(smoothedCrossovers[c], settings.crossovers[c]);
+
+    //a block where nothing is gliding or modulated runs the whole thing at one setting, the same as it always did
+    if (modulation != nullptr && ! modulation->affectsCrush())
+        modulation = nullptr;
+
+    auto smoothing = smoothedBitDepth.isSmoothing() || smoothedBitRate.isSmoothing()
+                  || smoothedCutoff.isSmoothing() || smoothedResonance.isSmoothing() || modulation != nullptr;
+
+    for (auto& ramps : bandRamps)
+        smoothing = smoothing || ramps.bitDepth.isSmoothing() || ramps.bitRate.isSmoothing() || ramps.mix.isSmoothing();
+
+    for (auto& ramp : smoothedCrossovers)
+        smoothing = smoothing || ramp.isSmoothing();
+
+    return smoothing;
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::skipRamps(int numSamples)
+{
+    smoothedBitDepth.skip(numSamples);
+    smoothedBitRate.skip(numSamples);
+    smoothedCutoff.skip(numSamples);
+    smoothedResonance.skip(numSamples);
+
+    for (auto& ramps : bandRamps)
+    {
+        ramps.bitDepth.skip(numSamples);
+        ramps.bitRate.skip(numSamples);
+        ramps.mix.skip(numSamples);
+    }
+
+    for (auto& ramp : smoothedCrossovers)
+        ramp.skip(numSamples);
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::processGroup(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                                           const Settings& settings, const ModulationBlock* modulation, bool smoothing)
+{
+    //with oversampling on, only the crush stage runs at the higher rate, the mix stays at the host rate
+    if (activeOversampling > 0)
+    {
+        auto& oversampler = *group.oversamplers[static_cast<size_t>(activeOversampling - 1)];
+        juce::dsp::AudioBlock<SampleType> upBlock;
+
+        {
+            BITCRUSHER_PROFILE_STAGE(profiler, oversampling);
+            upBlock = oversampler.processSamplesUp(input);
+        }
+
+        if (smoothing)
+            crushStageSmoothed(group, upBlock, upBlock, settings, modulation);
+        else
+            crushStage(group, upBlock, upBlock, settings, settings);
+
+        BITCRUSHER_PROFILE_STAGE(profiler, oversampling);
+        oversampler.processSamplesDown(output);
+    }
+    else if (smoothing)
+    {
+        crushStageSmoothed(group, input, output, settings, modulation);
+    }
+    else
+    {
+        crushStage(group, input, output, settings, settings);
+    }
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::crushStage(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                                         const Settings& settings, const Settings& start)
+{
+    const auto numSamples = static_cast<int>(input.getNumSamples());
+    const auto groupChannels = input.getNumChannels();
+
+    updateFilter(group, settings);
+
+    //the bands run the whole chain on their own, summing them back is the last thing that happens
+    if (settings.numBands > 1)
+    {
+        crushBands(group, input, output, settings, start);
+        return;
+    }
+
+    const auto startBitDepth = start.bitDepth;
+
+    //whole bit depths stay on the exact power of two path, only a depth caught mid glide takes exp2.
+    //a moving depth ramps inside the kernel, the dither sizes its noise for where the ramp starts
+    const auto ramping = startBitDepth != settings.bitDepth;
+    const auto wholeBits = static_cast<int>(settings.bitDepth);
+    const auto isWhole = ! ramping && static_cast<float>(wholeBits) == settings.bitDepth;
+    const auto ditherType = static_cast<typename Dither<SampleType>::Type>(settings.ditherType);
+    const auto scale = isWhole ? static_cast<SampleType>(1 << wholeBits) : std::exp2(static_cast<SampleType>(startBitDepth));
+
+    for (size_t ch = 0; ch < groupChannels; ++ch)
+    {
+        BITCRUSHER_PROFILE_STAGE(profiler, quantize);
+        const auto* src = input.getChannelPointer(ch);
+        auto* dest = output.getChannelPointer(ch);
+
+        if (ditherType == Dither<SampleType>::shaped)
+        {
+            group.dither.processShaped(static_cast<int>(ch), src, dest, numSamples, scale);
+            continue;
+        }
+
+        //the noise goes into the output and the kernel quantizes that in place
+        if (ditherType != Dither<SampleType>::off)
+        {
+            group.dither.addNoise(ditherType, static_cast<int>(ch), src, dest, numSamples, scale);
+            src = dest;
+        }
+
+        if (ramping)
+            crusher.processRamp(src, dest, numSamples, static_cast<SampleType>(startBitDepth), static_cast<SampleType>(settings.bitDepth));
+        else if (isWhole)
+            crusher.process(src, dest, numSamples, wholeBits);
+        else
+            crusher.processFractional(src, dest, numSamples, static_cast<SampleType>(settings.bitDepth));
+    }
+
+    {
+        BITCRUSHER_PROFILE_STAGE(profiler, filter);
+        group.filterBank.process(output);
+    }
+
+    BITCRUSHER_PROFILE_STAGE(profiler, decimate);
+
+    //the decimator keeps its phase and held sample between blocks, so the host's buffer size never changes the sound
+    for (size_t ch = 0; ch < groupChannels; ++ch)
+    {
+        group.decimators[ch].setRate(settings.bitRate, stageSampleRate);
+        group.decimators[ch].process(output.getChannelPointer(ch), numSamples);
+    }
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::crushBands(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                                         const Settings& settings, const Settings& start)
+{
+    const auto numSamples = static_cast<int>(input.getNumSamples());
+    const auto numBands = static_cast<size_t>(settings.numBands);
+    const auto ditherType = static_cast<typename Dither<SampleType>::Type>(settings.ditherType);
+
+    group.crossover.setParameters(settings.numBands, settings.crossovers.data(), stageSampleRate);
+
+    //a band with its mix at 0 the whole way only goes through the split, its quantizer, filter and decimator never run
+    std::array<bool, Settings::maxBands> active{};
+    for (size_t b = 0; b < numBands; ++b)
+    {
+        active[b] = settings.bands[b].mix != 0.f || start.bands[b].mix != 0.f;
+
+        if (active[b])
+            for (auto& decimator : group.bandDecimators[b])
+                decimator.setRate(settings.bands[b].bitRate, stageSampleRate);
+    }
+
+    //the split, crush, filter and sum of a chunk are all mixed in together, so the whole pass counts as the quantize stage
+    BITCRUSHER_PROFILE_STAGE(profiler, quantize);
+
+    SampleType bandData[Settings::maxBands][bandChunk];
+    SampleType crushed[bandChunk];
+    std::array<SampleType*, Settings::maxBands> bands;
+    for (size_t b = 0; b < bands.size(); ++b)
+        bands[b] = bandData[b];
+
+    //one pass over each channel, a chunk is split, every band of it crushed and mixed, and summed back before the next chunk is touched
+    for (size_t ch = 0; ch < input.getNumChannels(); ++ch)
+    {
+        const auto channel = static_cast<int>(ch);
+        const auto* src = input.getChannelPointer(ch);
+        auto* dest = output.getChannelPointer(ch);
+
+        for (int offset = 0; offset < numSamples; offset += bandChunk)
+        {
+            const auto length = juce::jmin(bandChunk, numSamples - offset);
+
+            //the depths and mixes run in straight lines across the whole call, each chunk takes its own stretch of them
+            const auto from = static_cast<float>(offset) / static_cast<float>(numSamples);
+            const auto to = static_cast<float>(offset + length) / static_cast<float>(numSamples);
+
+            group.crossover.split(channel, src + offset, bands.data(), length);
+
+            for (size_t b = 0; b < numBands; ++b)
+            {
+                if (! active[b])
+                    continue;
+
+                auto* band = bands[b];
+                const auto startBits = juce::jmap(from, start.bands[b].bitDepth, settings.bands[b].bitDepth);
+                const auto endBits = juce::jmap(to, start.bands[b].bitDepth, settings.bands[b].bitDepth);
+                const auto scale = std::exp2(static_cast<SampleType>(startBits));
+
+                if (ditherType == Dither<SampleType>::shaped)
+                {
+                    group.bandDithers[b].processShaped(channel, band, crushed, length, scale);
+                }
+                else
+                {
+                    const SampleType* quantizerInput = band;
+                    if (ditherType != Dither<SampleType>::off)
+                    {
+                        group.bandDithers[b].addNoise(ditherType, channel, band, crushed, length, scale);
+                        quantizerInput = crushed;
+                    }
+
+                    const auto wholeBits = static_cast<int>(endBits);
+                    if (startBits != endBits)
+                        crusher.processRamp(quantizerInput, crushed, length, static_cast<SampleType>(startBits), static_cast<SampleType>(endBits));
+                    else if (static_cast<float>(wholeBits) == endBits)
+                        crusher.process(quantizerInput, crushed, length, wholeBits);
+                    else
+                        crusher.processFractional(quantizerInput, crushed, length, static_cast<SampleType>(endBits));
+                }
+
+                //the same order as a single band, so the filter only ever sees the wet side of a band and a band left dry stays untouched
+                group.bandFilters[b].process(channel, crushed, length);
+                group.bandDecimators[b][ch].process(crushed, length);
+
+                //the band's own dry/wet goes on before the sum, the dry side is the band as it came out of the split
+                const auto mixStart = juce::jmap(from, start.bands[b].mix, settings.bands[b].mix);
+                const auto mixStep = (juce::jmap(to, start.bands[b].mix, settings.bands[b].mix) - mixStart) / static_cast<float>(length);
+
+                for (int s = 0; s < length; ++s)
+                    band[s] += (crushed[s] - band[s]) * static_cast<SampleType>(mixStart + mixStep * static_cast<float>(s));
+            }
+
+            group.crossover.join(channel, bands.data(), dest + offset, length);
+        }
+    }
+}
+
+template <typename SampleType>
+template <typename Callback>
+void CrushEngine<SampleType>::forEachStep(size_t numSamples, Settings settings, const ModulationBlock* modulation, Callback&& callback) const
+{
+    //each group walks its own copy of the ramps so they all see the same values, process() moves the real ones on after
+    auto bitDepthRamp = smoothedBitDepth;
+    auto bitRateRamp = smoothedBitRate;
+    auto cutoffRamp = smoothedCutoff;
+    auto resonanceRamp = smoothedResonance;
+    auto bandRampsCopy = bandRamps;
+    auto crossoverRamps = smoothedCrossovers;
+
+    //the modulation lands on top of the smoothed values, the depth in bits and the rate and cutoff in octaves
+    auto getDepth = [&](float smoothed, int point)
+    {
+        if (modulation != nullptr && modulation->isActive(ModulationBlock::depth))
+            smoothed += modulation->get(ModulationBlock::depth, point);
+
+        return juce::jlimit(1.f, static_cast<float>(CrushKernel::maxBits), smoothed);
+    };
+
+    auto modulate = [&](ModulationBlock::Target target, float smoothed, int point, float minimum, float maximum)
+    {
+        if (modulation != nullptr && modulation->isActive(target))
+            smoothed *= std::exp2(modulation->get(target, point));
+
+        return juce::jlimit(minimum, maximum, smoothed);
+    };
+
+    //the rate, cutoff and resonance step every smoothingInterval samples, a new coefficient set per sample would cost more than the whole chain.
+    //the depth is cheap to move, the kernel runs it in a straight line from one step to the next. the band mixes do the same
+    auto startSettings = settings;
+    auto point = 0;
+    for (size_t start = 0; start < numSamples; start += smoothingInterval, ++point)
+    {
+        const auto length = juce::jmin(smoothingInterval, numSamples - start);
+        startSettings.bitDepth = getDepth(bitDepthRamp.getCurrentValue(), point);
+
+        settings.bitDepth = getDepth(bitDepthRamp.skip(static_cast<int>(length)), point + 1);
+        settings.bitRate = modulate(ModulationBlock::rate, bitRateRamp.skip(static_cast<int>(length)), point + 1, 20.f, static_cast<float>(Decimator<SampleType>::maxRate));
+        settings.cutoff = modulate(ModulationBlock::cutoff, cutoffRamp.skip(static_cast<int>(length)), point + 1, 20.f, 20000.f);
+        settings.resonance = resonanceRamp.skip(static_cast<int>(length));
+
+        //every band takes the same modulation as the single band would
+        if (settings.numBands > 1)
+        {
+            for (size_t b = 0; b < bandRampsCopy.size(); ++b)
+            {
+                auto& ramps = bandRampsCopy[b];
+                startSettings.bands[b].bitDepth = getDepth(ramps.bitDepth.getCurrentValue(), point);
+                startSettings.bands[b].mix = ramps.mix.getCurrentValue();
+
+                settings.bands[b].bitDepth = getDepth(ramps.bitDepth.skip(static_cast<int>(length)), point + 1);
+                settings.bands[b].bitRate = modulate(ModulationBlock::rate, ramps.bitRate.skip(static_cast<int>(length)), point + 1, 20.f, static_cast<float>(Decimator<SampleType>::maxRate));
+                settings.bands[b].mix = ramps.mix.skip(static_cast<int>(length));
+            }
+
+            for (size_t c = 0; c < crossoverRamps.size(); ++c)
+                settings.crossovers[c] = crossoverRamps[c].skip(static_cast<int>(length));
+        }
+
+        callback(start, length, settings, startSettings);
+    }
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::crushStageSmoothed(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                                                 const Settings& settings, const ModulationBlock* modulation)
+{
+    //the smoothers count host samples, the stage may be running oversampled
+    const auto factor = static_cast<size_t>(1 << juce::jmax(0, activeOversampling));
+
+    forEachStep(input.getNumSamples() / factor, settings, modulation, [&](size_t start, size_t length, const Settings& end, const Settings& startSettings)
+    {
+        auto stageOutput = output.getSubBlock(start * factor, length * factor);
+        crushStage(group, input.getSubBlock(start * factor, length * factor), stageOutput, end, startSettings);
+    });
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::updateFilter(ChannelGroup& group, const Settings& settings)
+{
+    //the bank only redesigns when one of these moved, a new stage rate after an oversampling switch counts too
+    const auto type = static_cast<typename FilterBank<SampleType>::Type>(settings.filterType);
+
+    if (settings.numBands > 1)
+    {
+        for (size_t b = 0; b < static_cast<size_t>(settings.numBands); ++b)
+            group.bandFilters[b].setParameters(type, settings.filterOrder, settings.cutoff, settings.resonance, stageSampleRate);
+
+        return;
+    }
+
+    group.filterBank.setParameters(type, settings.filterOrder, settings.cutoff, settings.resonance, stageSampleRate);
+}
+
+template <typename SampleType>
+void CrushEngine<SampleType>::updateOversampling(int index)
+{
+    if (index == activeOversampling)
+        return;
+
+    activeOversampling = index;
+    stageSampleRate = sampleRate * static_cast<double>(1 << index);
+    latencySamples = getLatencySamples(index);
+
+    if (index > 0)
+        for (auto& group : groups)
+            group.oversamplers[static_cast<size_t>(index - 1)]->reset();
+
+    dryDelay.setDelay(latencySamples);
+}
+
+template class CrushEngine<float>;
+template class CrushEngine<double>;
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    CrushEngine.h
+    Created: 17 Oct 2026 5:48:52pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SharedResources.h"
+#include "Decimator.h"
+#include "Dither.h"
+#include "FilterBank.h"
+#include "Crossover.h"
+#include "DryDelay.h"
+#include "Profiling.h"
+#include "ChannelWorkers.h"
+#include "Modulation.h"
+
+//plain values, read from the parameters once per block by the processor
+struct CrushSettings
+{
+    float bitDepth = 16.f;
+    float bitRate = 192000.f;
+    float cutoff = 20000.f;
+    int oversamplingIndex = 0;
+    int ditherType = 0;
+    int filterType = 0;
+    int filterOrder = 2;
+    float resonance = 0.f;
+
+    //multiband. with one band it's the plain chain and everything below is ignored,
+    //with more each band gets its own depth, rate and mix, and its own copy of the filter
+    static constexpr int maxBands = Crossover<float>::maxBands;
+
+    struct Band
+    {
+        float bitDepth = 16.f;
+        float bitRate = 192000.f;
+        float mix = 1.f;
+    };
+
+    int numBands = 1;
+    std::array<float, maxBands - 1> crossovers{ 250.f, 2000.f, 8000.f };
+    std::array<Band, maxBands> bands{};
+};
+
+//The wet path of the plugin: quantize, filter and sample and hold, optionally oversampled.
+//With more than one band the input is split first and every band gets the whole chain to itself, the same filter settings on each.
+//It's a template on the sample type so float and double hosts both run it natively.
+//Everything is sized in prepare() for the channel count of the bus, process() never allocates.
+//The channels are split into groups that share no state, so an offline render can hand the groups to worker threads.
+template <typename SampleType>
+class CrushEngine
+{
+public:
+    using Settings = CrushSettings;
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, const Settings& settings);
+    void release();
+
+    //renders the wet signal for the input block and returns it, the block stays valid until the next call.
+    //modulation moves the depth, rate and cutoff on top of the settings, the mix is left to the caller.
+    //with workers the channel groups run in parallel, the output is the same either way
+    juce::dsp::AudioBlock<SampleType> process(const juce::dsp::AudioBlock<const SampleType>& input, const Settings& settings,
+                                              const ModulationBlock* modulation = nullptr, ChannelWorkers* workers = nullptr);
+
+    //moves everything that counts samples on as far as process() would have for numSamples of silence, without rendering them.
+    //the ramps, the hold grids and the dither draws end up where they would have, the filters are left as they are
+    void skip(int numInputChannels, int numSamples, const Settings& settings, const ModulationBlock* modulation = nullptr);
+
+    //latency of the active oversampling at the host rate
+    int getLatencySamples() const { return latencySamples; }
+
+    //latency any oversampling index will have, known from prepare() on so it can be reported before the switch happens
+    int getLatencySamples(int oversamplingIndex) const { return oversamplingLatencies[static_cast<size_t>(juce::jlimit(0, maxOversampling, oversamplingIndex))]; }
+    int getMaxLatencySamples() const { return oversamplingLatencies.back(); }
+
+    //the dry side of the mix, kept at the same latency as the wet block process() returns
+    DryDelay<SampleType>& getDryDelay() { return dryDelay; }
+
+    //how often a gliding or modulated rate or cutoff gets a new value, in host samples. the depth moves every sample in between
+    static constexpr size_t smoothingInterval = ModulationBlock::interval;
+
+    //the stages report their times here when profiling is compiled in, null turns it off
+    void setProfiler(BlockProfiler* p) { profiler = p; }
+
+private:
+    //the quantizer is shared with every other instance, it's read only
+    juce::SharedResourcePointer<SharedResources> shared;
+    const CrushKernel& crusher{ shared->crusher };
+
+    //the settings glide to new values instead of jumping. depth is linear in bits, rate and cutoff are in Hz so they move in ratios
+    juce::SmoothedValue<float> smoothedBitDepth, smoothedResonance;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedBitRate, smoothedCutoff;
+
+    //the same again for every band, they only move while there's more than one band
+    struct BandRamps
+    {
+        juce::SmoothedValue<float> bitDepth, mix;
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> bitRate;
+    };
+
+    std::array<BandRamps, Settings::maxBands> bandRamps;
+    std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>, Settings::maxBands - 1> smoothedCrossovers;
+
+    //2x, 4x and 8x
+    static constexpr int maxOversampling = 3;
+
+    //everything that keeps per channel state. groups of four keep the filter's simd lanes full,
+    //below four channels each channel gets a group of its own so stereo still splits in two
+    struct ChannelGroup
+    {
+        size_t firstChannel = 0, numChannels = 0;
+
+        Dither<SampleType> dither;
+        FilterBank<SampleType> filterBank;
+        std::vector<Decimator<SampleType>> decimators;
+
+        //the multiband split, and a dither, filter and decimators for every band
+        Crossover<SampleType> crossover;
+        std::array<Dither<SampleType>, Settings::maxBands> bandDithers;
+        std::array<FilterBank<SampleType>, Settings::maxBands> bandFilters;
+        std::array<std::vector<Decimator<SampleType>>, Settings::maxBands> bandDecimators;
+
+        //one oversampler per factor (2x, 4x, 8x), all built in prepare so switching never allocates
+        std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, maxOversampling> oversamplers;
+    };
+
+    static constexpr size_t channelsPerGroup = 4;
+
+    //the bands work through a channel this many samples at a time, all of a chunk's bands stay in l1 while they're split, crushed and summed
+    static constexpr int bandChunk = 64;
+
+    std::vector<ChannelGroup> groups;
+    size_t numChannels{ 0 };
+
+    int activeOversampling{ -1 };
+    int latencySamples{ 0 };
+    std::array<int, maxOversampling + 1> oversamplingLatencies{};
+
+    juce::AudioBuffer<SampleType> wetBuffer;
+    DryDelay<SampleType> dryDelay;
+
+    double sampleRate{ 44100.0 };
+    double stageSampleRate{ 44100.0 };
+
+    BlockProfiler* profiler{ nullptr };
+
+    //points the ramps at the settings, true when anything glides or is modulated during the block. modulation is dropped when it doesn't touch the crush
+    bool updateTargets(const Settings& settings, const ModulationBlock*& modulation);
+    void skipRamps(int numSamples);
+
+    //hands the callback every smoothingInterval step of a gliding block: its start and length in host samples, the settings it ends on and where it starts
+    template <typename Callback>
+    void forEachStep(size_t numSamples, Settings settings, const ModulationBlock* modulation, Callback&& callback) const;
+
+    void skipGroup(ChannelGroup& group, size_t groupChannels, int numSamples, const Settings& settings, const Settings& start);
+
+    void updateFilter(ChannelGroup& group, const Settings& settings);
+    void updateOversampling(int index);
+    void processGroup(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                      const Settings& settings, const ModulationBlock* modulation, bool smoothing);
+
+    //start is where the depths and band mixes were on the first sample, they glide from there to the ones in settings across the block
+    void crushStage(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                    const Settings& settings, const Settings& start);
+    void crushBands(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                    const Settings& settings, const Settings& start);
+    void crushStageSmoothed(ChannelGroup& group, const juce::dsp::AudioBlock<const SampleType>& input, juce::dsp::AudioBlock<SampleType>& output,
+                            const Settings& settings, const ModulationBlock* modulation);
+};
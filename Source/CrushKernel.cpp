@@ -0,0 +1,352 @@
+/*
+  ==============================================================================
+
+    CrushKernel.cpp
+    Created: 17 Oct 2026 10:02:11am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "CrushKernel.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+
+ #if JUCE_GCC || JUCE_CLANG
+  #define CRUSH_TARGET_AVX2 __attribute__((target("avx2")))
+ #else
+  #define CRUSH_TARGET_AVX2
+ #endif
+#endif
+
+CrushKernel::CrushKernel()
+{
+   #if JUCE_INTEL
+    if (juce::SystemStats::hasAVX2())
+    {
+        floatKernel = &CrushKernel::processAVX2;
+        doubleKernel = &CrushKernel::processAVX2;
+        floatRamp = &CrushKernel::processRampAVX2;
+        doubleRamp = &CrushKernel::processRampAVX2;
+    }
+    else if (juce::SystemStats::hasSSE2())
+    {
+        floatKernel = &CrushKernel::processSSE2;
+        doubleKernel = &CrushKernel::processSSE2;
+        floatRamp = &CrushKernel::processRampSSE2;
+        doubleRamp = &CrushKernel::processRampSSE2;
+    }
+   #endif
+
+    //every path has to land on exactly the same samples as the old loop, check it once up front
+    jassert(matchesReference<float>());
+    jassert(matchesReference<double>());
+}
+
+void CrushKernel::process(const float* src, float* dest, int numSamples, int bits) const
+{
+    //2^bits and its inverse are exact in float for 1-16 bits, so multiplying by the inverse is the same as dividing
+    jassert(bits >= 1 && bits <= maxBits);
+    const auto scale = static_cast<float>(1 << juce::jlimit(1, maxBits, bits));
+    floatKernel(src, dest, numSamples, scale, 1.f / scale);
+}
+
+void CrushKernel::process(const double* src, double* dest, int numSamples, int bits) const
+{
+    jassert(bits >= 1 && bits <= maxBits);
+    const auto scale = static_cast<double>(1 << juce::jlimit(1, maxBits, bits));
+    doubleKernel(src, dest, numSamples, scale, 1.0 / scale);
+}
+
+void CrushKernel::processFractional(const float* src, float* dest, int numSamples, float bits) const
+{
+    auto scale = std::exp2(bits);
+    floatKernel(src, dest, numSamples, scale, 1.f / scale);
+}
+
+void CrushKernel::processFractional(const double* src, double* dest, int numSamples, double bits) const
+{
+    auto scale = std::exp2(bits);
+    doubleKernel(src, dest, numSamples, scale, 1.0 / scale);
+}
+
+void CrushKernel::processRamp(const float* src, float* dest, int numSamples, float startBits, float endBits) const
+{
+    if (numSamples > 0)
+        floatRamp(src, dest, numSamples, std::exp2(startBits), std::exp2((endBits - startBits) / static_cast<float>(numSamples)));
+}
+
+void CrushKernel::processRamp(const double* src, double* dest, int numSamples, double startBits, double endBits) const
+{
+    if (numSamples > 0)
+        doubleRamp(src, dest, numSamples, std::exp2(startBits), std::exp2((endBits - startBits) / static_cast<double>(numSamples)));
+}
+
+void CrushKernel::processScalar(const float* src, float* dest, int numSamples, float scale, float invScale)
+{
+    for (int s = 0; s < numSamples; ++s)
+        dest[s] = std::floor(src[s] * scale) * invScale;
+}
+
+void CrushKernel::processScalar(const double* src, double* dest, int numSamples, double scale, double invScale)
+{
+    for (int s = 0; s < numSamples; ++s)
+        dest[s] = std::floor(src[s] * scale) * invScale;
+}
+
+//the inverse walks down by the inverse ratio alongside the scale, so there's no divide per sample
+template <typename SampleType>
+static void processRampScalarImpl(const SampleType* src, SampleType* dest, int numSamples, SampleType scale, SampleType ratio)
+{
+    auto invScale = SampleType(1) / scale;
+    const auto invRatio = SampleType(1) / ratio;
+
+    for (int s = 0; s < numSamples; ++s)
+    {
+        dest[s] = std::floor(src[s] * scale) * invScale;
+        scale *= ratio;
+        invScale *= invRatio;
+    }
+}
+
+void CrushKernel::processRampScalar(const float* src, float* dest, int numSamples, float scale, float ratio)
+{
+    processRampScalarImpl(src, dest, numSamples, scale, ratio);
+}
+
+void CrushKernel::processRampScalar(const double* src, double* dest, int numSamples, double scale, double ratio)
+{
+    processRampScalarImpl(src, dest, numSamples, scale, ratio);
+}
+
+//the scale each lane starts on, one sample further along the ramp per lane, and the ratio that moves every lane a whole vector on
+template <typename SampleType, size_t NumLanes>
+static SampleType getRampLanes(std::array<SampleType, NumLanes>& lanes, SampleType scale, SampleType ratio)
+{
+    lanes[0] = scale;
+    for (size_t i = 1; i < NumLanes; ++i)
+        lanes[i] = lanes[i - 1] * ratio;
+
+    return lanes[NumLanes - 1] * ratio / scale;
+}
+
+#if JUCE_INTEL
+//sse2 has no floor, so truncate through int and step down where that rounded up.
+//anything past 2^23 is already whole (and covers inf/nan), and the sign bit is carried so -0 stays -0
+static inline __m128 floorSSE2(__m128 v)
+{
+    const auto one = _mm_set1_ps(1.f);
+    const auto wholeLimit = _mm_set1_ps(8388608.f);
+    const auto signMask = _mm_set1_ps(-0.f);
+
+    auto t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), one));
+    t = _mm_or_ps(t, _mm_and_ps(v, signMask));
+
+    auto isWhole = _mm_cmpnlt_ps(_mm_andnot_ps(signMask, v), wholeLimit);
+    return _mm_or_ps(_mm_and_ps(isWhole, v), _mm_andnot_ps(isWhole, t));
+}
+
+//doubles don't fit the int trick, so round through the 2^52 magic number instead (exact below 2^52),
+//then step down where that rounded up. the sign goes back on afterwards so -0 and small negatives come out right
+static inline __m128d floorSSE2(__m128d v)
+{
+    const auto one = _mm_set1_pd(1.0);
+    const auto magic = _mm_set1_pd(4503599627370496.0);
+    const auto signMask = _mm_set1_pd(-0.0);
+
+    auto magnitude = _mm_andnot_pd(signMask, v);
+
+    auto t = _mm_sub_pd(_mm_add_pd(magnitude, magic), magic);
+    t = _mm_or_pd(t, _mm_and_pd(v, signMask));
+    t = _mm_sub_pd(t, _mm_and_pd(_mm_cmpgt_pd(t, v), one));
+
+    auto isWhole = _mm_cmpnlt_pd(magnitude, magic);
+    return _mm_or_pd(_mm_and_pd(isWhole, v), _mm_andnot_pd(isWhole, t));
+}
+
+void CrushKernel::processSSE2(const float* src, float* dest, int numSamples, float scale, float invScale)
+{
+    const auto vScale = _mm_set1_ps(scale);
+    const auto vInvScale = _mm_set1_ps(invScale);
+
+    int s = 0;
+    for (; s + 4 <= numSamples; s += 4)
+    {
+        auto floored = floorSSE2(_mm_mul_ps(_mm_loadu_ps(src + s), vScale));
+        _mm_storeu_ps(dest + s, _mm_mul_ps(floored, vInvScale));
+    }
+
+    processScalar(src + s, dest + s, numSamples - s, scale, invScale);
+}
+
+void CrushKernel::processSSE2(const double* src, double* dest, int numSamples, double scale, double invScale)
+{
+    const auto vScale = _mm_set1_pd(scale);
+    const auto vInvScale = _mm_set1_pd(invScale);
+
+    int s = 0;
+    for (; s + 2 <= numSamples; s += 2)
+    {
+        auto floored = floorSSE2(_mm_mul_pd(_mm_loadu_pd(src + s), vScale));
+        _mm_storeu_pd(dest + s, _mm_mul_pd(floored, vInvScale));
+    }
+
+    processScalar(src + s, dest + s, numSamples - s, scale, invScale);
+}
+
+CRUSH_TARGET_AVX2 void CrushKernel::processAVX2(const float* src, float* dest, int numSamples, float scale, float invScale)
+{
+    const auto vScale = _mm256_set1_ps(scale);
+    const auto vInvScale = _mm256_set1_ps(invScale);
+
+    int s = 0;
+    for (; s + 8 <= numSamples; s += 8)
+    {
+        auto v = _mm256_mul_ps(_mm256_loadu_ps(src + s), vScale);
+        auto floored = _mm256_round_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        _mm256_storeu_ps(dest + s, _mm256_mul_ps(floored, vInvScale));
+    }
+
+    processScalar(src + s, dest + s, numSamples - s, scale, invScale);
+}
+
+CRUSH_TARGET_AVX2 void CrushKernel::processAVX2(const double* src, double* dest, int numSamples, double scale, double invScale)
+{
+    const auto vScale = _mm256_set1_pd(scale);
+    const auto vInvScale = _mm256_set1_pd(invScale);
+
+    int s = 0;
+    for (; s + 4 <= numSamples; s += 4)
+    {
+        auto v = _mm256_mul_pd(_mm256_loadu_pd(src + s), vScale);
+        auto floored = _mm256_round_pd(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        _mm256_storeu_pd(dest + s, _mm256_mul_pd(floored, vInvScale));
+    }
+
+    processScalar(src + s, dest + s, numSamples - s, scale, invScale);
+}
+void CrushKernel::processRampSSE2(const float* src, float* dest, int numSamples, float scale, float ratio)
+{
+    std::array<float, 4> lanes;
+    const auto step = getRampLanes(lanes, scale, ratio);
+
+    auto vScale = _mm_loadu_ps(lanes.data());
+    auto vInvScale = _mm_div_ps(_mm_set1_ps(1.f), vScale);
+    const auto vStep = _mm_set1_ps(step);
+    const auto vInvStep = _mm_set1_ps(1.f / step);
+
+    int s = 0;
+    for (; s + 4 <= numSamples; s += 4)
+    {
+        auto floored = floorSSE2(_mm_mul_ps(_mm_loadu_ps(src + s), vScale));
+        _mm_storeu_ps(dest + s, _mm_mul_ps(floored, vInvScale));
+
+        vScale = _mm_mul_ps(vScale, vStep);
+        vInvScale = _mm_mul_ps(vInvScale, vInvStep);
+    }
+
+    processRampScalar(src + s, dest + s, numSamples - s, _mm_cvtss_f32(vScale), ratio);
+}
+
+void CrushKernel::processRampSSE2(const double* src, double* dest, int numSamples, double scale, double ratio)
+{
+    std::array<double, 2> lanes;
+    const auto step = getRampLanes(lanes, scale, ratio);
+
+    auto vScale = _mm_loadu_pd(lanes.data());
+    auto vInvScale = _mm_div_pd(_mm_set1_pd(1.0), vScale);
+    const auto vStep = _mm_set1_pd(step);
+    const auto vInvStep = _mm_set1_pd(1.0 / step);
+
+    int s = 0;
+    for (; s + 2 <= numSamples; s += 2)
+    {
+        auto floored = floorSSE2(_mm_mul_pd(_mm_loadu_pd(src + s), vScale));
+        _mm_storeu_pd(dest + s, _mm_mul_pd(floored, vInvScale));
+
+        vScale = _mm_mul_pd(vScale, vStep);
+        vInvScale = _mm_mul_pd(vInvScale, vInvStep);
+    }
+
+    processRampScalar(src + s, dest + s, numSamples - s, _mm_cvtsd_f64(vScale), ratio);
+}
+
+CRUSH_TARGET_AVX2 void CrushKernel::processRampAVX2(const float* src, float* dest, int numSamples, float scale, float ratio)
+{
+    std::array<float, 8> lanes;
+    const auto step = getRampLanes(lanes, scale, ratio);
+
+    auto vScale = _mm256_loadu_ps(lanes.data());
+    auto vInvScale = _mm256_div_ps(_mm256_set1_ps(1.f), vScale);
+    const auto vStep = _mm256_set1_ps(step);
+    const auto vInvStep = _mm256_set1_ps(1.f / step);
+
+    int s = 0;
+    for (; s + 8 <= numSamples; s += 8)
+    {
+        auto floored = _mm256_round_ps(_mm256_mul_ps(_mm256_loadu_ps(src + s), vScale), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        _mm256_storeu_ps(dest + s, _mm256_mul_ps(floored, vInvScale));
+
+        vScale = _mm256_mul_ps(vScale, vStep);
+        vInvScale = _mm256_mul_ps(vInvScale, vInvStep);
+    }
+
+    processRampScalar(src + s, dest + s, numSamples - s, _mm256_cvtss_f32(vScale), ratio);
+}
+
+CRUSH_TARGET_AVX2 void CrushKernel::processRampAVX2(const double* src, double* dest, int numSamples, double scale, double ratio)
+{
+    std::array<double, 4> lanes;
+    const auto step = getRampLanes(lanes, scale, ratio);
+
+    auto vScale = _mm256_loadu_pd(lanes.data());
+    auto vInvScale = _mm256_div_pd(_mm256_set1_pd(1.0), vScale);
+    const auto vStep = _mm256_set1_pd(step);
+    const auto vInvStep = _mm256_set1_pd(1.0 / step);
+
+    int s = 0;
+    for (; s + 4 <= numSamples; s += 4)
+    {
+        auto floored = _mm256_round_pd(_mm256_mul_pd(_mm256_loadu_pd(src + s), vScale), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        _mm256_storeu_pd(dest + s, _mm256_mul_pd(floored, vInvScale));
+
+        vScale = _mm256_mul_pd(vScale, vStep);
+        vInvScale = _mm256_mul_pd(vInvScale, vInvStep);
+    }
+
+    processRampScalar(src + s, dest + s, numSamples - s, _mm256_cvtsd_f64(vScale), ratio);
+}
+#endif
+
+template <typename SampleType>
+bool CrushKernel::matchesReference() const
+{
+    //a slow sweep through +-1.5 plus the values that tend to trip up floor tricks
+    constexpr int numTestSamples = 1031;
+    std::array<SampleType, numTestSamples> input, expected, actual;
+
+    for (int s = 0; s < numTestSamples; ++s)
+        input[s] = static_cast<SampleType>(-1.5 + 3.0 * s / (numTestSamples - 1));
+
+    input[0] = static_cast<SampleType>(-0.0);
+    input[1] = static_cast<SampleType>(0.0);
+    input[2] = static_cast<SampleType>(1.0);
+    input[3] = static_cast<SampleType>(-1.0);
+    input[4] = static_cast<SampleType>(1.0e-7);
+    input[5] = static_cast<SampleType>(-1.0e-7);
+    input[6] = static_cast<SampleType>(300000.0);
+    input[7] = static_cast<SampleType>(-300000.0);
+
+    for (int bits = 1; bits <= 16; ++bits)
+    {
+        processReference(input.data(), expected.data(), numTestSamples, bits);
+        process(input.data(), actual.data(), numTestSamples, bits);
+
+        if (std::memcmp(expected.data(), actual.data(), sizeof(expected)) != 0)
+            return false;
+    }
+
+    return true;
+}
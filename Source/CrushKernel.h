@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    CrushKernel.h
+    Created: 17 Oct 2026 10:02:11am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Block quantizer for the crush stage. The widest SIMD path the cpu supports is picked once
+//when the kernel is built, after that every call runs a whole channel with one bit depth.
+//Float and double each get their own set of paths so neither precision needs a conversion.
+struct CrushKernel
+{
+    CrushKernel();
+
+    static constexpr int maxBits = 16;
+
+    //dest[i] = floor(src[i] * 2^bits) / 2^bits, bit for bit the same as the old per sample pow/floor
+    void process(const float* src, float* dest, int numSamples, int bits) const;
+    void process(const double* src, double* dest, int numSamples, int bits) const;
+
+    //same floor onto a grid of 2^bits steps for depths in between whole bits, used while the depth glides
+    void processFractional(const float* src, float* dest, int numSamples, float bits) const;
+    void processFractional(const double* src, double* dest, int numSamples, double bits) const;
+
+    //a depth moving from startBits on the first sample towards endBits, for modulated depths. the step size changes every sample,
+    //geometrically so it's still linear in bits, which keeps it to two extra multiplies a sample instead of an exp2
+    void processRamp(const float* src, float* dest, int numSamples, float startBits, float endBits) const;
+    void processRamp(const double* src, double* dest, int numSamples, double startBits, double endBits) const;
+
+    //the old per sample maths, kept as the reference every other path has to match
+    template <typename SampleType>
+    static void processReference(const SampleType* src, SampleType* dest, int numSamples, int bits)
+    {
+        for (int s = 0; s < numSamples; ++s)
+        {
+            auto crusher = pow(2, bits);
+            dest[s] = static_cast<SampleType>(floor(crusher * src[s]) / crusher);
+        }
+    }
+
+    static void processScalar(const float* src, float* dest, int numSamples, float scale, float invScale);
+    static void processScalar(const double* src, double* dest, int numSamples, double scale, double invScale);
+   #if JUCE_INTEL
+    static void processSSE2(const float* src, float* dest, int numSamples, float scale, float invScale);
+    static void processSSE2(const double* src, double* dest, int numSamples, double scale, double invScale);
+    static void processAVX2(const float* src, float* dest, int numSamples, float scale, float invScale);
+    static void processAVX2(const double* src, double* dest, int numSamples, double scale, double invScale);
+   #endif
+
+    //scale is 2^bits on the first sample, every sample after multiplies it by ratio
+    static void processRampScalar(const float* src, float* dest, int numSamples, float scale, float ratio);
+    static void processRampScalar(const double* src, double* dest, int numSamples, double scale, double ratio);
+   #if JUCE_INTEL
+    static void processRampSSE2(const float* src, float* dest, int numSamples, float scale, float ratio);
+    static void processRampSSE2(const double* src, double* dest, int numSamples, double scale, double ratio);
+    static void processRampAVX2(const float* src, float* dest, int numSamples, float scale, float ratio);
+    static void processRampAVX2(const double* src, double* dest, int numSamples, double scale, double ratio);
+   #endif
+
+private:
+    template <typename SampleType>
+    using KernelFn = void (*)(const SampleType*, SampleType*, int, SampleType, SampleType);
+
+    //whole and fractional depths both go through these, the scale only costs a broadcast per call
+    KernelFn<float> floatKernel{ &CrushKernel::processScalar };
+    KernelFn<double> doubleKernel{ &CrushKernel::processScalar };
+
+    //runtime scale moving by a ratio every sample, for modulated depths
+    KernelFn<float> floatRamp{ &CrushKernel::processRampScalar };
+    KernelFn<double> doubleRamp{ &CrushKernel::processRampScalar };
+
+    template <typename SampleType>
+    bool matchesReference() const;
+};
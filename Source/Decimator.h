@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    Decimator.h
+    Created: 17 Oct 2026 1:15:48pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Sample and hold for the rate reduction. The phase is a 32 bit fixed point accumulator that
+//wraps once per held step, so the hold carries across blocks and any fractional rate in Hz works.
+//Integer phase keeps it exact: the same input gives the same output whatever the block sizes are.
+template <typename SampleType>
+struct Decimator
+{
+    void reset()
+    {
+        //park the phase right before a wrap so the very first sample gets picked up
+        phase = std::numeric_limits<juce::uint32>::max();
+        held = SampleType();
+    }
+
+    //the top of the rate range means no hold at all. oversampled stages run above it, so it can't be left to the ratio
+    static constexpr double maxRate = 192000.0;
+
+    void setRate(double targetRate, double sampleRate)
+    {
+        auto ratio = targetRate / sampleRate;
+        increment = ratio >= 1.0 || targetRate >= maxRate ? phaseWrap
+                                 : juce::jmax((juce::uint64) 1, static_cast<juce::uint64>(ratio * static_cast<double>(phaseWrap)));
+    }
+
+    bool isActive() const { return increment < phaseWrap; }
+
+    void process(SampleType* data, int numSamples)
+    {
+        if (! isActive())
+        {
+            //nothing to hold, keep the phase parked so switching back in starts on a fresh sample
+            if (numSamples > 0)
+                held = data[numSamples - 1];
+
+            phase = std::numeric_limits<juce::uint32>::max();
+            return;
+        }
+
+        int s = 0;
+        while (s < numSamples)
+        {
+            //how many steps until the accumulator wraps, the wrapping sample is the next one to hold
+            auto stepsToWrap = (phaseWrap - phase + increment - 1) / increment;
+            auto remaining = static_cast<juce::uint64>(numSamples - s);
+
+            if (stepsToWrap > remaining)
+            {
+                std::fill(data + s, data + numSamples, held);
+                phase = static_cast<juce::uint32>(phase + remaining * increment);
+                return;
+            }
+
+            auto heldRun = static_cast<int>(stepsToWrap) - 1;
+            std::fill(data + s, data + s + heldRun, held);
+            s += heldRun;
+
+            held = data[s++];
+            phase = static_cast<juce::uint32>(phase + stepsToWrap * increment);
+        }
+    }
+
+    //where process() would be after numSamples of silence, for when the silence is never actually rendered
+    void skip(int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (! isActive())
+        {
+            held = SampleType();
+            phase = std::numeric_limits<juce::uint32>::max();
+            return;
+        }
+
+        //a wrap on the way would have picked up one of the silent samples
+        const auto samples = static_cast<juce::uint64>(numSamples);
+        if ((phaseWrap - phase + increment - 1) / increment <= samples)
+            held = SampleType();
+
+        phase = static_cast<juce::uint32>(phase + samples * increment);
+    }
+
+private:
+    static constexpr juce::uint64 phaseWrap = (juce::uint64) 1 << 32;
+
+    juce::uint64 increment{ phaseWrap };
+    juce::uint32 phase{ std::numeric_limits<juce::uint32>::max() };
+    SampleType held{};
+};
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    Dither.h
+    Created: 17 Oct 2026 8:26:03pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Dither in front of the quantizer. The crusher floors, so every mode adds half a step first,
+//that turns the floor into a round and takes away the dc offset plain truncation leaves.
+//  rpdf   - one uniform draw, +-1/2 step
+//  tpdf   - two uniform draws summed, +-1 step, noise level no longer follows the signal
+//  shaped - tpdf with first order error feedback, pushes the noise up towards nyquist
+//The noise comes from xorshift32 generators, a group of them per channel stepped side by side
+//so the compiler can vectorise them, nothing like juce::Random per sample.
+//Each channel keeps its place in the last draw, so sample n always gets the same noise whatever the call lengths were.
+template <typename SampleType>
+class Dither
+{
+public:
+    enum Type { off, rpdf, tpdf, shaped };
+
+    //firstChannel is where these channels sit on the bus, so a dither covering part of it seeds the same as one covering all of it
+    void prepare(int numChannels, int firstChannel = 0)
+    {
+        channels.resize(static_cast<size_t>(numChannels));
+        seedOffset = static_cast<juce::uint64>(firstChannel * numLanes);
+        reset();
+    }
+
+    void reset()
+    {
+        //every lane of every channel gets its own seed, splitmix spreads them out so neighbours aren't correlated
+        juce::uint64 seed = 0x9e3779b97f4a7c15ULL * (seedOffset + 1);
+
+        for (auto& c : channels)
+        {
+            for (auto& state : c.lanes)
+            {
+                seed += 0x9e3779b97f4a7c15ULL;
+                auto z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                state = static_cast<juce::uint32>(z ^ (z >> 31)) | 1u;
+            }
+
+            c.error = SampleType();
+            c.used = numLanes;
+        }
+    }
+
+    //dest = src plus dither for a quantizer with steps of 1 / scale, ready for the floor kernel
+    void addNoise(Type type, int channel, const SampleType* src, SampleType* dest, int numSamples, SampleType scale)
+    {
+        jassert(type == rpdf || type == tpdf);
+
+        auto& c = channels[static_cast<size_t>(channel)];
+        const auto step = SampleType(1) / scale;
+        const auto offset = step * SampleType(.5);
+
+        for (int s = 0; s < numSamples;)
+        {
+            const auto length = c.next(numSamples - s);
+            const auto* draw = c.lanes.data() + c.used - length;
+
+            if (type == tpdf)
+            {
+                for (int i = 0; i < length; ++i)
+                    dest[s + i] = src[s + i] + offset + triangular(draw[i]) * step;
+            }
+            else
+            {
+                for (int i = 0; i < length; ++i)
+                    dest[s + i] = src[s + i] + offset + uniform(draw[i]) * step;
+            }
+
+            s += length;
+        }
+    }
+
+    //shaped dither has to see each quantized sample before the next one, so it quantizes itself
+    void processShaped(int channel, const SampleType* src, SampleType* dest, int numSamples, SampleType scale)
+    {
+        auto& c = channels[static_cast<size_t>(channel)];
+        const auto invScale = SampleType(1) / scale;
+        auto error = c.error;
+
+        for (int s = 0; s < numSamples;)
+        {
+            const auto length = c.next(numSamples - s);
+            const auto* draw = c.lanes.data() + c.used - length;
+
+            for (int i = 0; i < length; ++i)
+            {
+                auto v = src[s + i] - error;
+                auto y = std::floor((v + triangular(draw[i]) * invScale) * scale + SampleType(.5)) * invScale;
+                error = y - v;
+                dest[s + i] = y;
+            }
+
+            s += length;
+        }
+
+        c.error = error;
+    }
+
+    //moves a channel's noise on past numSamples without using it, the next call carries on where that many samples would have left it
+    void skip(int channel, int numSamples)
+    {
+        auto& c = channels[static_cast<size_t>(channel)];
+
+        for (int s = 0; s < numSamples;)
+            s += c.next(numSamples - s);
+    }
+
+private:
+    static constexpr int numLanes = 8;
+
+    struct Channel
+    {
+        std::array<juce::uint32, numLanes> lanes{};
+        SampleType error{};
+
+        //lanes of the current draw already handed out, a new draw starts once all of them are gone
+        int used = numLanes;
+
+        void step()
+        {
+            for (auto& x : lanes)
+            {
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+            }
+        }
+
+        //hands out up to maxLength lanes of the current draw, they end at lanes[used]
+        int next(int maxLength)
+        {
+            if (used == numLanes)
+            {
+                step();
+                used = 0;
+            }
+
+            const auto length = juce::jmin(numLanes - used, maxLength);
+            used += length;
+            return length;
+        }
+    };
+
+    //-1/2 to 1/2, the top bits as a signed number
+    static SampleType uniform(juce::uint32 x)
+    {
+        return static_cast<SampleType>(static_cast<juce::int32>(x)) * SampleType(1.0 / 4294967296.0);
+    }
+
+    //-1 to 1, the two 16 bit halves of one draw summed
+    static SampleType triangular(juce::uint32 x)
+    {
+        auto low = static_cast<juce::int32>(x << 16);
+        auto high = static_cast<juce::int32>(x & 0xffff0000u);
+        return (static_cast<SampleType>(low) + static_cast<SampleType>(high)) * SampleType(1.0 / 4294967296.0);
+    }
+
+    std::vector<Channel> channels;
+    juce::uint64 seedOffset = 0;
+};
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    DryDelay.h
+    Created: 17 Oct 2026 7:12:40pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Delays the dry signal by the latency of the wet path so the two line up in the crossfade.
+//It runs inside the mix loop one sample at a time, so the dry signal never gets its own copy.
+//The ring is a power of two long and sized in prepare() for the longest latency the wet path can have.
+//The ring always holds the latest input, with no delay it's just copied in by write(), so a new delay
+//can crossfade from the old read position to the new one instead of jumping or starting from silence.
+template <typename SampleType>
+class DryDelay
+{
+public:
+    void prepare(int numChannels, int maxDelay, int newFadeLength)
+    {
+        auto size = juce::nextPowerOfTwo(maxDelay + 1);
+        mask = size - 1;
+        fadeLength = juce::jmax(0, newFadeLength);
+        ring.setSize(numChannels, size, false, true, false);
+        reset();
+    }
+
+    void reset()
+    {
+        ring.clear();
+        writePos = 0;
+        fadeRemaining = 0;
+    }
+
+    void setDelay(int newDelay)
+    {
+        jassert(newDelay <= mask);
+        newDelay = juce::jlimit(0, mask, newDelay);
+
+        if (newDelay != delay)
+        {
+            previousDelay = delay;
+            delay = newDelay;
+            fadeRemaining = fadeLength;
+        }
+    }
+
+    int getDelay() const { return delay; }
+
+    //false when the dry can go straight through, the block still has to be handed to write() then
+    bool isActive() const { return delay > 0 || fadeRemaining > 0; }
+
+    //the ring for one channel, every channel starts the block at the same position
+    struct Channel
+    {
+        SampleType process(SampleType x)
+        {
+            data[pos] = x;
+            auto y = data[(pos - delay) & mask];
+
+            if (fadeRemaining > 0)
+            {
+                auto previous = data[(pos - previousDelay) & mask];
+                y += (previous - y) * static_cast<SampleType>(fadeRemaining) / static_cast<SampleType>(fadeLength);
+                --fadeRemaining;
+            }
+
+            pos = (pos + 1) & mask;
+            return y;
+        }
+
+        SampleType* data;
+        int pos, mask, delay, previousDelay, fadeRemaining, fadeLength;
+    };
+
+    Channel getChannel(int channel) { return { ring.getWritePointer(channel), writePos, mask, delay, previousDelay, fadeRemaining, fadeLength }; }
+
+    //keeps the ring up to date for a channel that didn't go through process(), it's a copy and nothing comes out
+    void write(int channel, const SampleType* src, int numSamples)
+    {
+        auto* data = ring.getWritePointer(channel);
+        const auto size = mask + 1;
+        auto start = writePos;
+
+        if (numSamples > size)
+        {
+            start = (writePos + numSamples - size) & mask;
+            src += numSamples - size;
+            numSamples = size;
+        }
+
+        const auto first = juce::jmin(numSamples, size - start);
+        std::copy_n(src, first, data + start);
+        std::copy_n(src + first, numSamples - first, data);
+    }
+
+    //call once the block is done with every channel
+    void advance(int numSamples)
+    {
+        writePos = (writePos + numSamples) & mask;
+        fadeRemaining = juce::jmax(0, fadeRemaining - numSamples);
+    }
+
+private:
+    juce::AudioBuffer<SampleType> ring;
+    int writePos = 0, mask = 0, delay = 0;
+    int previousDelay = 0, fadeRemaining = 0, fadeLength = 0;
+};
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+    FilterBank.cpp
+    Created: 17 Oct 2026 9:04:37pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "FilterBank.h"
+
+//one sample through the cascade. Value is either a plain sample or a simd register holding a sample per channel,
+//NumSections of 0 is the first order section. the section count is a template argument so the loop unrolls
+template <int NumSections, typename Value>
+static Value tick(Value x, Value* s, const Value* c)
+{
+    if (NumSections == 0)
+    {
+        auto y = c[0] * x + s[0];
+        s[0] = c[1] * x - c[2] * y;
+        return y;
+    }
+
+    for (int i = 0; i < NumSections; ++i)
+    {
+        const auto* k = c + 3 * i;
+        auto& ic1 = s[2 * i];
+        auto& ic2 = s[2 * i + 1];
+
+        auto v3 = x - ic2;
+        auto v1 = k[0] * ic1 + k[1] * v3;
+        auto v2 = ic2 + k[1] * ic1 + k[2] * v3;
+        ic1 = v1 + v1 - ic1;
+        ic2 = v2 + v2 - ic2;
+        x = v2;
+    }
+
+    return x;
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::prepare(int numChannels)
+{
+    state.assign(static_cast<size_t>(numChannels * stateSize), SampleType());
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::reset()
+{
+    std::fill(state.begin(), state.end(), SampleType());
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::setParameters(Type newType, int order, float cutoff, float resonance, double sampleRate)
+{
+    //orders 2, 4 and 8, anything else rounds down to one of those
+    auto newSections = newType == firstOrder ? 0 : (order >= 8 ? 4 : (order >= 4 ? 2 : 1));
+
+    if (newType != type || newSections != numSections)
+    {
+        type = newType;
+        numSections = newSections;
+        lastCutoff = -1.f;
+        reset();
+    }
+
+    if (cutoff == lastCutoff && resonance == lastResonance && sampleRate == lastSampleRate)
+        return;
+
+    lastCutoff = cutoff;
+    lastResonance = resonance;
+    lastSampleRate = sampleRate;
+    design(cutoff, resonance, sampleRate);
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::design(float cutoff, float resonance, double sampleRate)
+{
+    if (type == firstOrder)
+    {
+        //comes back as b0, b1, a0, a1
+        auto c = juce::dsp::IIR::ArrayCoefficients<SampleType>::makeFirstOrderLowPass(sampleRate, static_cast<SampleType>(cutoff));
+        auto a0inv = SampleType(1) / c[2];
+        coefficients[0] = c[0] * a0inv;
+        coefficients[1] = c[1] * a0inv;
+        coefficients[2] = c[3] * a0inv;
+        return;
+    }
+
+    const auto order = numSections * 2;
+    const auto pi = juce::MathConstants<double>::pi;
+
+    //chebyshev ripple in dB, sets how far the poles get squeezed towards the axis
+    const auto ripple = .5 + 5.5 * resonance;
+    const auto epsilon = std::sqrt(std::pow(10.0, ripple / 10.0) - 1.0);
+    const auto mu = std::asinh(1.0 / epsilon) / order;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        //the angle of this section's pole pair, i = 0 is the one closest to the axis
+        const auto theta = pi * (2 * i + 1) / (2 * order);
+        auto frequency = static_cast<double>(cutoff);
+        auto q = 1.0 / (2.0 * std::sin(theta));
+
+        if (type == butterworth)
+        {
+            if (i == 0)
+                q *= 1.0 + 7.0 * resonance;
+        }
+        else if (type == chebyshev)
+        {
+            auto sigma = std::sinh(mu) * std::sin(theta);
+            auto omega = std::cosh(mu) * std::cos(theta);
+            auto radius = std::sqrt(sigma * sigma + omega * omega);
+
+            frequency *= radius;
+            q = radius / (2.0 * sigma);
+        }
+        else
+        {
+            //the resonance is spread over the stack so the higher orders don't run away
+            q = .5 + resonance * 4.0 / numSections;
+        }
+
+        frequency = juce::jlimit(10.0, sampleRate * .49, frequency);
+
+        auto g = std::tan(pi * frequency / sampleRate);
+        auto k = 1.0 / q;
+        auto a1 = 1.0 / (1.0 + g * (g + k));
+        auto a2 = g * a1;
+        auto a3 = g * a2;
+
+        coefficients[static_cast<size_t>(3 * i)] = static_cast<SampleType>(a1);
+        coefficients[static_cast<size_t>(3 * i + 1)] = static_cast<SampleType>(a2);
+        coefficients[static_cast<size_t>(3 * i + 2)] = static_cast<SampleType>(a3);
+    }
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::process(juce::dsp::AudioBlock<SampleType>& block)
+{
+    jassert(block.getNumChannels() * static_cast<size_t>(stateSize) <= state.size());
+
+    switch (numSections)
+    {
+        case 0:  processBlock<0>(block); break;
+        case 1:  processBlock<1>(block); break;
+        case 2:  processBlock<2>(block); break;
+        default: processBlock<4>(block); break;
+    }
+}
+
+template <typename SampleType>
+void FilterBank<SampleType>::process(int channel, SampleType* data, int numSamples)
+{
+    const auto ch = static_cast<size_t>(channel);
+    const auto length = static_cast<size_t>(numSamples);
+    jassert((ch + 1) * static_cast<size_t>(stateSize) <= state.size());
+
+    switch (numSections)
+    {
+        case 0:  processChannel<0>(ch, data, length); break;
+        case 1:  processChannel<1>(ch, data, length); break;
+        case 2:  processChannel<2>(ch, data, length); break;
+        default: processChannel<4>(ch, data, length); break;
+    }
+}
+
+template <typename SampleType>
+template <int NumSections>
+void FilterBank<SampleType>::processBlock(juce::dsp::AudioBlock<SampleType>& block)
+{
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+    size_t ch = 0;
+
+   #if JUCE_USE_SIMD
+    //the filter is the one serial part of the chain, every sample waits on the last one.
+    //with four or more channels each simd lane carries a channel, so a single dependency chain covers a whole group
+    using Lanes = juce::dsp::SIMDRegister<SampleType>;
+    constexpr auto numLanes = Lanes::size();
+
+    if (numChannels >= 4)
+    {
+        std::array<Lanes, maxSections * 3> c;
+        for (size_t i = 0; i < c.size(); ++i)
+            c[i] = Lanes::expand(coefficients[i]);
+
+        for (; ch + numLanes <= numChannels; ch += numLanes)
+        {
+            std::array<SampleType*, numLanes> channels;
+            std::array<Lanes, stateSize> s;
+            alignas(Lanes::SIMDRegisterSize) SampleType frame[numLanes];
+
+            for (size_t i = 0; i < numLanes; ++i)
+                channels[i] = block.getChannelPointer(ch + i);
+
+            for (size_t j = 0; j < s.size(); ++j)
+            {
+                for (size_t i = 0; i < numLanes; ++i)
+                    frame[i] = state[(ch + i) * s.size() + j];
+
+                s[j] = Lanes::fromRawArray(frame);
+            }
+
+            for (size_t n = 0; n < numSamples; ++n)
+            {
+                for (size_t i = 0; i < numLanes; ++i)
+                    frame[i] = channels[i][n];
+
+                auto y = tick<NumSections>(Lanes::fromRawArray(frame), s.data(), c.data());
+
+                y.copyToRawArray(frame);
+                for (size_t i = 0; i < numLanes; ++i)
+                    channels[i][n] = frame[i];
+            }
+
+            for (size_t j = 0; j < s.size(); ++j)
+            {
+                s[j].copyToRawArray(frame);
+
+                for (size_t i = 0; i < numLanes; ++i)
+                    state[(ch + i) * s.size() + j] = frame[i];
+            }
+        }
+    }
+   #endif
+
+    //whatever doesn't fill a group of lanes, same maths one channel at a time
+    for (; ch < numChannels; ++ch)
+        processChannel<NumSections>(ch, block.getChannelPointer(ch), numSamples);
+}
+
+template <typename SampleType>
+template <int NumSections>
+void FilterBank<SampleType>::processChannel(size_t channel, SampleType* data, size_t numSamples)
+{
+    std::array<SampleType, stateSize> s;
+    auto channelState = state.begin() + static_cast<std::ptrdiff_t>(channel * s.size());
+    std::copy_n(channelState, s.size(), s.begin());
+
+    for (size_t n = 0; n < numSamples; ++n)
+        data[n] = tick<NumSections>(data[n], s.data(), coefficients.data());
+
+    std::copy(s.begin(), s.end(), channelState);
+}
+
+template class FilterBank<float>;
+template class FilterBank<double>;
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    FilterBank.h
+    Created: 17 Oct 2026 9:04:37pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//The low pass after the crush. Apart from the original first order section everything is a
+//cascade of topology preserving state variable sections, they stay stable however fast the cutoff moves.
+//  butterworth - maximally flat, resonance lifts the sharpest pole pair
+//  chebyshev   - type 1, resonance sets the passband ripple from 0.5 to 6 dB
+//  svf         - identical resonant sections stacked up, the synth filter sound
+//With four or more channels the channels run side by side in simd lanes.
+template <typename SampleType>
+class FilterBank
+{
+public:
+    enum Type { firstOrder, butterworth, chebyshev, svf };
+    static constexpr int maxOrder = 8;
+
+    void prepare(int numChannels);
+    void reset();
+
+    //only redesigns when something actually changed, a new type or order also clears the state
+    void setParameters(Type type, int order, float cutoff, float resonance, double sampleRate);
+
+    void process(juce::dsp::AudioBlock<SampleType>& block);
+
+    //one channel of the bank on its own, for callers that work through a channel at a time
+    void process(int channel, SampleType* data, int numSamples);
+
+private:
+    static constexpr int maxSections = maxOrder / 2;
+    static constexpr int stateSize = maxSections * 2;
+
+    //first order: b0, b1, a1. sections: a1, a2, a3 of each svf section in turn
+    std::array<SampleType, maxSections * 3> coefficients{};
+    std::vector<SampleType> state;
+
+    Type type{ firstOrder };
+    int numSections{ 0 };
+    float lastCutoff{ -1.f }, lastResonance{ -1.f };
+    double lastSampleRate{ 0.0 };
+
+    void design(float cutoff, float resonance, double sampleRate);
+
+    template <int NumSections>
+    void processBlock(juce::dsp::AudioBlock<SampleType>& block);
+
+    template <int NumSections>
+    void processChannel(size_t channel, SampleType* data, size_t numSamples);
+};
@@ -96,9 +96,15 @@ void Laf::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int heigh
         }
         else if (slider.getName() == "Rate" || slider.getName() == "Frequency" || (slider.getName() == "Depth" && slider.getTitle() == "fmDepth"))
         {
-            str = String(value);
+            str = String(roundToInt(value));
             str.append(" Hz", 5);
         }
+        else if (slider.getName() == "Depth")
+        {
+            //the depth glides through fractional bits, one decimal is enough to read it
+            str = String(value, 1);
+            str.append(" bit", 4);
+        }
         else if (value <= 1) {
             value *= 100;
             str = String(value);
@@ -422,27 +428,60 @@ void Laf::drawPopupMenuItem(juce::Graphics& g, const juce::Rectangle<int>& area,
 
 void Laf::LevelMeter::paint(juce::Graphics& g)
 {
+    using namespace juce;
+
+    //get our base rectangle
+    g.setColour(Colours::black);
+    g.fillRoundedRectangle(meterBounds, 5.f);
+
+    //Show gradient, the strip is already rendered so this just fills with it
+    auto levelMeterFill = meterBounds.withTop(getLevelTop(level));
+    if (levelMeterFill.getHeight() > 0.f)
     {
-        using namespace juce;
+        g.setFillType(FillType(gradientStrip, AffineTransform::translation(meterBounds.getX(), meterBounds.getY())));
+        g.fillRoundedRectangle(levelMeterFill, 5.f);
+    }
+}
 
-        //shapes the meters. May be a bit inefficeint, not sure the best way to move this stuff around, but it is there.
-        auto bounds = getLocalBounds().toFloat();
-        bounds = bounds.removeFromLeft(bounds.getWidth() * .75);
-        bounds = bounds.removeFromRight(bounds.getWidth() * .66);
-        bounds = bounds.removeFromTop(bounds.getHeight() * .9);
-        bounds = bounds.removeFromBottom(bounds.getHeight() * .88);
+void Laf::LevelMeter::resized()
+{
+    using namespace juce;
 
-        //get our base rectangle
-        g.setColour(Colours::black);
-        g.fillRoundedRectangle(bounds, 5.f);
+    //shapes the meters. May be a bit inefficeint, not sure the best way to move this stuff around, but it is there.
+    auto bounds = getLocalBounds().toFloat();
+    bounds = bounds.removeFromLeft(bounds.getWidth() * .75);
+    bounds = bounds.removeFromRight(bounds.getWidth() * .66);
+    bounds = bounds.removeFromTop(bounds.getHeight() * .9);
+    bounds = bounds.removeFromBottom(bounds.getHeight() * .88);
+    meterBounds = bounds;
+
+    //the full height gradient is drawn once here, paint only ever uses part of it
+    gradientStrip = Image(Image::ARGB, jmax(1, roundToInt(bounds.getWidth())), jmax(1, roundToInt(bounds.getHeight())), true);
+    Graphics g(gradientStrip);
+
+    auto stripBounds = gradientStrip.getBounds().toFloat();
+    auto gradient = ColourGradient::ColourGradient(Colours::green, stripBounds.getBottomLeft(), Colours::red, stripBounds.getTopLeft(), false);
+    gradient.addColour(.5f, Colours::yellow);
+    g.setGradientFill(gradient);
+    g.fillAll();
+}
 
-        //get gradient
-        auto gradient = ColourGradient::ColourGradient(Colours::green, bounds.getBottomLeft(), Colours::red, bounds.getTopLeft(), false);
-        gradient.addColour(.5f, Colours::yellow);
-        g.setGradientFill(gradient);
+void Laf::LevelMeter::setLevel(float value)
+{
+    auto oldTop = getLevelTop(level);
+    auto newTop = getLevelTop(value);
+    level = value;
 
-        //Show gradient
-        auto levelMeterFill = jmap(level, -60.f, +6.f, 0.f, static_cast<float>(bounds.getHeight()));
-        g.fillRoundedRectangle(bounds.removeFromBottom(levelMeterFill), 5.f);
-    }
-}
\ No newline at end of file
+    if (juce::roundToInt(oldTop) == juce::roundToInt(newTop))
+        return;
+
+    //pad by the corner radius so the rounded top of the fill gets redrawn too
+    auto changed = meterBounds.withTop(juce::jmin(oldTop, newTop)).withBottom(juce::jmax(oldTop, newTop)).expanded(1.f, 6.f);
+    repaint(changed.getSmallestIntegerContainer());
+}
+
+float Laf::LevelMeter::getLevelTop(float value) const
+{
+    auto levelMeterFill = juce::jmap(juce::jlimit(-60.f, 6.f, value), -60.f, +6.f, 0.f, meterBounds.getHeight());
+    return meterBounds.getBottom() - levelMeterFill;
+}
@@ -32,11 +32,18 @@ struct Laf : juce::LookAndFeel_V4 {
     struct LevelMeter : juce::Component
     {
         void paint(juce::Graphics& g) override;
+        void resized() override;
         
-        //default value so the meters  are black when the plugin is launched
-        void setLevel(float value) { level = value; }
+        //only repaints the strip between the old and the new level, nothing at all if it didn't move a pixel
+        void setLevel(float value);
 
     private:
+        //default value so the meters  are black when the plugin is launched
         float level = -60.f;
+
+        juce::Rectangle<float> meterBounds;
+        juce::Image gradientStrip;
+
+        float getLevelTop(float value) const;
     };
 };
\ No newline at end of file
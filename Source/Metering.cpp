@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    Metering.cpp
+    Created: 17 Oct 2026 3:31:09pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "Metering.h"
+
+void LevelMeters::prepare(double newSampleRate, int newNumChannels)
+{
+    jassert(newNumChannels <= maxChannels);
+
+    sampleRate = newSampleRate;
+    numChannels = juce::jmin(newNumChannels, maxChannels);
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        heldPeak[point].assign(static_cast<size_t>(numChannels), 0.f);
+        meanSquare[point].assign(static_cast<size_t>(numChannels), 0.f);
+    }
+
+    truePeak.assign(static_cast<size_t>(numChannels), TruePeakState());
+
+    reset();
+}
+
+void LevelMeters::reset()
+{
+    for (int point = 0; point < numPoints; ++point)
+    {
+        std::fill(heldPeak[point].begin(), heldPeak[point].end(), 0.f);
+        std::fill(meanSquare[point].begin(), meanSquare[point].end(), 0.f);
+
+        for (auto& r : readouts[point])
+        {
+            r.peak.store(0.f, std::memory_order_relaxed);
+            r.meanSquare.store(0.f, std::memory_order_relaxed);
+        }
+    }
+
+    for (auto& state : truePeak)
+    {
+        state.history.fill(0.f);
+        state.writePos = 0;
+        state.held = 0.f;
+    }
+
+    for (auto& r : truePeakReadouts)
+        r.store(0.f, std::memory_order_relaxed);
+}
+
+void LevelMeters::beginBlock(int numSamples)
+{
+    auto blockSeconds = static_cast<double>(numSamples) / sampleRate;
+
+    rmsCoefficient = static_cast<float>(std::exp(-blockSeconds * 1000.0 / rmsWindowMs.load(std::memory_order_relaxed)));
+    peakRelease = juce::Decibels::decibelsToGain(static_cast<float>(-peakFallDbPerSecond * blockSeconds));
+}
+
+template <typename SampleType>
+void LevelMeters::measure(Point point, int channel, const SampleType* data, int numSamples)
+{
+    //four running sums keep the adds independent so the loop isn't bound by a single dependency chain
+    SampleType peak = 0;
+    std::array<SampleType, 4> sums{};
+
+    int s = 0;
+    for (; s + 4 <= numSamples; s += 4)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            auto x = data[s + i];
+            peak = juce::jmax(peak, std::abs(x));
+            sums[static_cast<size_t>(i)] += x * x;
+        }
+    }
+
+    for (; s < numSamples; ++s)
+    {
+        peak = juce::jmax(peak, std::abs(data[s]));
+        sums[0] += data[s] * data[s];
+    }
+
+    publish(point, channel, static_cast<float>(peak), static_cast<float>(sums[0] + sums[1] + sums[2] + sums[3]), numSamples);
+}
+
+template void LevelMeters::measure<float>(Point, int, const float*, int);
+template void LevelMeters::measure<double>(Point, int, const double*, int);
+
+void LevelMeters::publish(Point point, int channel, float peak, float sumOfSquares, int numSamples)
+{
+    if (channel >= numChannels || numSamples == 0)
+        return;
+
+    auto& held = heldPeak[point][static_cast<size_t>(channel)];
+    auto& ms = meanSquare[point][static_cast<size_t>(channel)];
+
+    held = juce::jmax(peak, held * peakRelease);
+    ms = ms * rmsCoefficient + (1.f - rmsCoefficient) * (sumOfSquares / static_cast<float>(numSamples));
+
+    auto& readout = readouts[point][static_cast<size_t>(channel)];
+    readout.peak.store(held, std::memory_order_relaxed);
+    readout.meanSquare.store(ms, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void LevelMeters::measureTruePeak(int channel, const SampleType* data, int numSamples)
+{
+    if (channel >= numChannels)
+        return;
+
+    auto& state = truePeak[static_cast<size_t>(channel)];
+    auto peak = state.held * peakRelease;
+
+    for (int s = 0; s < numSamples; ++s)
+    {
+        //the history is written twice so the last truePeakTaps samples always sit in one straight run
+        //the meter side is all float, a double input only loses precision far below the meter floor
+        auto x = static_cast<float>(data[s]);
+        state.history[static_cast<size_t>(state.writePos)] = x;
+        state.history[static_cast<size_t>(state.writePos + truePeakTaps)] = x;
+        state.writePos = (state.writePos + 1) % truePeakTaps;
+
+        const auto* window = state.history.data() + state.writePos;
+        peak = juce::jmax(peak, std::abs(x));
+
+        for (auto& coeffs : shared->truePeakCoefficients)
+        {
+            auto y = 0.f;
+            for (int t = 0; t < truePeakTaps; ++t)
+                y += window[t] * coeffs[static_cast<size_t>(t)];
+
+            peak = juce::jmax(peak, std::abs(y));
+        }
+    }
+
+    state.held = peak;
+    truePeakReadouts[static_cast<size_t>(channel)].store(peak, std::memory_order_relaxed);
+}
+
+template void LevelMeters::measureTruePeak<float>(int, const float*, int);
+template void LevelMeters::measureTruePeak<double>(int, const double*, int);
+
+float LevelMeters::getPeak(Point point, int channel) const
+{
+    if (! juce::isPositiveAndBelow(channel, maxChannels))
+        return floorDb;
+
+    return juce::Decibels::gainToDecibels(readouts[point][static_cast<size_t>(channel)].peak.load(std::memory_order_relaxed), floorDb);
+}
+
+float LevelMeters::getRMS(Point point, int channel) const
+{
+    if (! juce::isPositiveAndBelow(channel, maxChannels))
+        return floorDb;
+
+    return juce::Decibels::gainToDecibels(std::sqrt(readouts[point][static_cast<size_t>(channel)].meanSquare.load(std::memory_order_relaxed)), floorDb);
+}
+
+float LevelMeters::getTruePeak(int channel) const
+{
+    if (! juce::isPositiveAndBelow(channel, maxChannels))
+        return floorDb;
+
+    return juce::Decibels::gainToDecibels(truePeakReadouts[static_cast<size_t>(channel)].load(std::memory_order_relaxed), floorDb);
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    Metering.h
+    Created: 17 Oct 2026 3:31:09pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SharedResources.h"
+
+//Peak, RMS and true peak for the input and output of the processor. The audio thread measures
+//inside the processing pass and publishes through relaxed atomics, readers never block it.
+//While no consumer is attached (no editor open) the audio thread skips all of it.
+//The audio side state is sized in prepare(), the readouts the editor sees are fixed so they never move under it.
+class LevelMeters
+{
+public:
+    enum Point { input, output, numPoints };
+    
+    //9.1.6, enough for any bed up to and past 7.1.4
+    static constexpr int maxChannels = 16;
+
+    //============================================================================== audio side
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    bool isActive() const { return numConsumers.load(std::memory_order_relaxed) > 0; }
+
+    //works out the per block decay factors, call once before pushing a block
+    void beginBlock(int numSamples);
+
+    //measures a channel in a single pass
+    template <typename SampleType>
+    void measure(Point point, int channel, const SampleType* data, int numSamples);
+
+    //for callers that already have the peak and sum of squares from their own loop
+    void publish(Point point, int channel, float peak, float sumOfSquares, int numSamples);
+
+    //4x oversampled peak of the output, catches the overs that land between samples
+    template <typename SampleType>
+    void measureTruePeak(int channel, const SampleType* data, int numSamples);
+
+    //============================================================================== reader side
+    //all in decibels, floored at the bottom of the meter range
+    float getPeak(Point point, int channel) const;
+    float getRMS(Point point, int channel) const;
+    float getTruePeak(int channel) const;
+
+    void setRmsWindow(float milliseconds) { rmsWindowMs.store(juce::jmax(1.f, milliseconds)); }
+
+    //meters only run while at least one of these is alive
+    struct ScopedConsumer
+    {
+        explicit ScopedConsumer(LevelMeters& m) : meters(m) { ++meters.numConsumers; }
+        ~ScopedConsumer() { --meters.numConsumers; }
+
+    private:
+        LevelMeters& meters;
+        JUCE_DECLARE_NON_COPYABLE(ScopedConsumer)
+    };
+
+    static constexpr float floorDb = -60.f;
+
+private:
+    static constexpr int truePeakTaps = SharedResources::truePeakTaps;
+
+    juce::SharedResourcePointer<SharedResources> shared;
+
+    struct Readout
+    {
+        std::atomic<float> peak{ 0.f }, meanSquare{ 0.f };
+    };
+
+    struct TruePeakState
+    {
+        std::array<float, truePeakTaps * 2> history{};
+        int writePos = 0;
+        float held = 0.f;
+    };
+
+    std::array<std::array<Readout, maxChannels>, numPoints> readouts;
+    std::array<std::atomic<float>, maxChannels> truePeakReadouts{};
+
+    std::array<std::vector<float>, numPoints> heldPeak, meanSquare;
+    std::vector<TruePeakState> truePeak;
+
+    std::atomic<int> numConsumers{ 0 };
+    std::atomic<float> rmsWindowMs{ 300.f };
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    float rmsCoefficient = 0.f;
+    float peakRelease = 0.f;
+
+    static constexpr float peakFallDbPerSecond = 20.f;
+};
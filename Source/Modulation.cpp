@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    Modulation.cpp
+    Created: 18 Oct 2026 1:37:52am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "Modulation.h"
+
+void ModulationBlock::fill(Target target, float* dest, int numSamples) const
+{
+    const auto* points = offsets[static_cast<size_t>(target)];
+
+    for (int k = 0; k + 1 < numPoints; ++k)
+    {
+        const auto start = k * interval;
+        const auto length = juce::jmin(interval, numSamples - start);
+        const auto step = (points[k + 1] - points[k]) / static_cast<float>(length);
+
+        for (int s = 0; s < length; ++s)
+            dest[start + s] = points[k] + step * static_cast<float>(s);
+    }
+}
+
+//==============================================================================
+//beats per lfo cycle, in the same order as the division names
+static constexpr std::array<double, 12> beatsPerCycle{ 16.0, 8.0, 4.0, 2.0, 4.0 / 3.0, 1.0, 2.0 / 3.0, .5, 1.0 / 3.0, .25, 1.0 / 6.0, .125 };
+
+const juce::StringArray& Modulators::getDivisionNames()
+{
+    static const juce::StringArray names{ "4 Bars", "2 Bars", "1 Bar", "1/2", "1/2T", "1/4", "1/4T", "1/8", "1/8T", "1/16", "1/16T", "1/32" };
+    return names;
+}
+
+const juce::StringArray& Modulators::getShapeNames()
+{
+    static const juce::StringArray names{ "Sine", "Triangle", "Saw", "Square", "Random" };
+    return names;
+}
+
+const juce::StringArray& Modulators::getSourceNames()
+{
+    static const juce::StringArray names{ "Off", "LFO 1", "LFO 2", "Envelope" };
+    return names;
+}
+
+void Modulators::prepare(double newSampleRate, int maxBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxPoints = maxBlockSize / ModulationBlock::interval + 2;
+
+    for (auto& values : sources)
+        values.assign(static_cast<size_t>(maxPoints), 0.f);
+
+    for (auto& values : offsets)
+        values.assign(static_cast<size_t>(maxPoints), 0.f);
+
+    reset();
+}
+
+void Modulators::reset()
+{
+    //a fixed seed, so an offline render of the random shape comes out the same every time
+    rng.setSeed(0x10f0);
+
+    for (auto& h : held)
+        h = rng.nextFloat() * 2.f - 1.f;
+
+    phase.fill(0.0);
+    lastOffset.fill(0.f);
+    envelopeLevel = 0.f;
+}
+
+template <typename SampleType>
+const ModulationBlock& Modulators::process(const juce::AudioBuffer<SampleType>& input, int numChannels, int numSamples, const Settings& settings, const Timing& timing)
+{
+    const auto numPoints = 1 + (numSamples + ModulationBlock::interval - 1) / ModulationBlock::interval;
+    jassert(numPoints <= maxPoints);
+
+    //only the sources something is listening to get worked out
+    std::array<bool, numSources> used{};
+    for (size_t t = 0; t < settings.source.size(); ++t)
+        if (settings.source[t] != off && settings.amount[t] != 0.f)
+            used[static_cast<size_t>(settings.source[t])] = true;
+
+    for (int i = 0; i < numLfos; ++i)
+        runLfo(i, numPoints, numSamples, used[static_cast<size_t>(lfo1 + i)], settings, timing);
+
+    if (used[envelope])
+        runEnvelope(input, numChannels, numPoints, numSamples, settings);
+
+    constexpr std::array<float, ModulationBlock::numTargets> spans{ depthSpanBits, rateSpanOctaves, cutoffSpanOctaves, 1.f };
+
+    for (size_t t = 0; t < offsets.size(); ++t)
+    {
+        const auto source = static_cast<size_t>(settings.source[t]);
+        const auto amount = settings.amount[t] * spans[t];
+        const auto routed = source != off && amount != 0.f;
+
+        //a target that was just switched off still gets one block to glide back to nothing
+        if (! routed && lastOffset[t] == 0.f)
+        {
+            block.offsets[t] = nullptr;
+            continue;
+        }
+
+        auto& values = offsets[t];
+        values[0] = lastOffset[t];
+
+        for (int k = 1; k < numPoints; ++k)
+            values[static_cast<size_t>(k)] = routed ? sources[source][static_cast<size_t>(k)] * amount : 0.f;
+
+        lastOffset[t] = values[static_cast<size_t>(numPoints - 1)];
+        block.offsets[t] = values.data();
+    }
+
+    block.numPoints = numPoints;
+    return block;
+}
+
+static float getShapeValue(int shape, double phase, float held)
+{
+    switch (shape)
+    {
+        case Modulators::triangle: return static_cast<float>(1.0 - 4.0 * std::abs(phase - .5));
+        case Modulators::saw:      return static_cast<float>(2.0 * phase - 1.0);
+        case Modulators::square:   return phase < .5 ? 1.f : -1.f;
+        case Modulators::random:   return held;
+        default:                   return static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * phase));
+    }
+}
+
+void Modulators::runLfo(int index, int numPoints, int numSamples, bool used, const Settings& settings, const Timing& timing)
+{
+    const auto i = static_cast<size_t>(index);
+    const auto beats = beatsPerCycle[static_cast<size_t>(juce::jlimit(0, static_cast<int>(beatsPerCycle.size()) - 1, settings.division[i]))];
+    const auto increment = juce::jmax(1.0, timing.bpm) / (60.0 * sampleRate * beats);
+
+    //locked to the host's position while it has one, otherwise the phase just carries on from the last block
+    auto& p = phase[i];
+    if (timing.hasPosition)
+        p = timing.ppqPosition / beats;
+
+    p -= std::floor(p);
+
+    if (used)
+    {
+        auto& values = sources[static_cast<size_t>(lfo1 + index)];
+        auto cycle = 0.0;
+
+        for (int k = 1; k < numPoints; ++k)
+        {
+            auto position = p + increment * static_cast<double>(juce::jmin(k * ModulationBlock::interval, numSamples));
+            auto whole = std::floor(position);
+
+            //the random shape picks a new value every time a cycle starts
+            if (whole != cycle)
+            {
+                cycle = whole;
+                held[i] = rng.nextFloat() * 2.f - 1.f;
+            }
+
+            values[static_cast<size_t>(k)] = getShapeValue(settings.shape[i], position - whole, held[i]);
+        }
+    }
+
+    p += increment * static_cast<double>(numSamples);
+    p -= std::floor(p);
+}
+
+template <typename SampleType>
+void Modulators::runEnvelope(const juce::AudioBuffer<SampleType>& input, int numChannels, int numPoints, int numSamples, const Settings& settings)
+{
+    auto& values = sources[envelope];
+
+    auto getCoefficient = [this](float ms, int length)
+    {
+        return static_cast<float>(std::exp(-static_cast<double>(length) / (juce::jmax(.1, static_cast<double>(ms)) * .001 * sampleRate)));
+    };
+
+    //whole intervals all share one pair, only a short last interval needs its own
+    const auto attack = getCoefficient(settings.attackMs, ModulationBlock::interval);
+    const auto release = getCoefficient(settings.releaseMs, ModulationBlock::interval);
+
+    for (int k = 1; k < numPoints; ++k)
+    {
+        const auto start = (k - 1) * ModulationBlock::interval;
+        const auto length = juce::jmin(ModulationBlock::interval, numSamples - start);
+
+        //the follower sees the loudest sample of the interval across every channel
+        auto peak = 0.f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(input.getReadPointer(ch, start), length);
+            peak = juce::jmax(peak, static_cast<float>(juce::jmax(-range.getStart(), range.getEnd())));
+        }
+
+        auto coefficient = peak > envelopeLevel ? attack : release;
+        if (length != ModulationBlock::interval)
+            coefficient = getCoefficient(peak > envelopeLevel ? settings.attackMs : settings.releaseMs, length);
+
+        envelopeLevel = peak + (envelopeLevel - peak) * coefficient;
+
+        //-60 dB up to full scale covers the whole 0 to 1
+        values[static_cast<size_t>(k)] = juce::jlimit(0.f, 1.f, 1.f + juce::Decibels::gainToDecibels(envelopeLevel, -60.f) / 60.f);
+    }
+}
+
+template const ModulationBlock& Modulators::process<float>(const juce::AudioBuffer<float>&, int, int, const Settings&, const Timing&);
+template const ModulationBlock& Modulators::process<double>(const juce::AudioBuffer<double>&, int, int, const Settings&, const Timing&);
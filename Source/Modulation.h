@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    Modulation.h
+    Created: 18 Oct 2026 1:37:52am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//What the modulators hand the engine for one block: an offset per target at control rate.
+//Point k sits at sample k * interval, the last one at the end of the block, and point 0 is where the previous block ended,
+//so anything reading it can go straight from one point to the next without a jump at the block edge.
+struct ModulationBlock
+{
+    enum Target { depth, rate, cutoff, mix, numTargets };
+
+    //the same step the engine's smoothing runs at, one new set of filter coefficients and decimator rates per interval
+    static constexpr int interval = 32;
+
+    //bits for the depth, octaves for the rate and cutoff, plain amount for the mix. null when nothing drives that target
+    std::array<const float*, numTargets> offsets{};
+    int numPoints = 0;
+
+    bool isActive(Target target) const { return offsets[static_cast<size_t>(target)] != nullptr; }
+    bool affectsCrush() const { return isActive(depth) || isActive(rate) || isActive(cutoff); }
+
+    float get(Target target, int point) const { return offsets[static_cast<size_t>(target)][point]; }
+
+    //the offset for every sample of the block, straight lines between the points
+    void fill(Target target, float* dest, int numSamples) const;
+};
+
+//Two tempo synced LFOs and an envelope follower on the input. Each crush target picks one of them as its source
+//and an amount, from -1 to 1. Everything here runs once per interval, a block costs the same whatever is routed where.
+//With a host position the LFOs lock to the bar, without one (offline, or a stopped transport) they run free at the host tempo.
+class Modulators
+{
+public:
+    enum Source { off, lfo1, lfo2, envelope, numSources };
+    enum Shape { sine, triangle, saw, square, random };
+    static constexpr int numLfos = 2;
+
+    //the parameter choices, in order
+    static const juce::StringArray& getDivisionNames();
+    static const juce::StringArray& getShapeNames();
+    static const juce::StringArray& getSourceNames();
+
+    //how far a full amount moves each target, either way
+    static constexpr float depthSpanBits = 15.f;
+    static constexpr float rateSpanOctaves = 8.f;
+    static constexpr float cutoffSpanOctaves = 6.f;
+
+    struct Settings
+    {
+        std::array<int, numLfos> division{}, shape{};
+        float attackMs = 5.f, releaseMs = 150.f;
+
+        std::array<int, ModulationBlock::numTargets> source{};
+        std::array<float, ModulationBlock::numTargets> amount{};
+    };
+
+    struct Timing
+    {
+        double bpm = 120.0;
+        bool hasPosition = false;
+        double ppqPosition = 0.0;
+    };
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    //the input is read for the envelope, it has to be called before anything writes to the buffer
+    template <typename SampleType>
+    const ModulationBlock& process(const juce::AudioBuffer<SampleType>& input, int numChannels, int numSamples, const Settings& settings, const Timing& timing);
+
+private:
+    double sampleRate = 44100.0;
+    int maxPoints = 0;
+
+    std::array<double, numLfos> phase{};
+    std::array<float, numLfos> held{};
+    juce::Random rng{ 0x10f0 };
+    float envelopeLevel = 0.f;
+
+    //the sources and the targets per control point, sized in prepare
+    std::array<std::vector<float>, numSources> sources;
+    std::array<std::vector<float>, ModulationBlock::numTargets> offsets;
+    std::array<float, ModulationBlock::numTargets> lastOffset{};
+
+    ModulationBlock block;
+
+    void runLfo(int index, int numPoints, int numSamples, bool used, const Settings& settings, const Timing& timing);
+
+    template <typename SampleType>
+    void runEnvelope(const juce::AudioBuffer<SampleType>& input, int numChannels, int numPoints, int numSamples, const Settings& settings);
+};
@@ -8,14 +8,16 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "BinaryData.h"
 
 //==============================================================================
 BitCrusherAudioProcessorEditor::BitCrusherAudioProcessorEditor (BitCrusherAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p),
+    : AudioProcessorEditor (&p), audioProcessor (p), meterConsumer (p.getMeters()),
     bitDepthAT(audioProcessor.apvts, "bitDepth", bitDepth),
     bitRateAT(audioProcessor.apvts, "bitRate", bitRate),
     mixAT(audioProcessor.apvts, "mix", mix),
-    cutoffAT(audioProcessor.apvts, "cutoff", cutoff)
+    cutoffAT(audioProcessor.apvts, "cutoff", cutoff),
+    analyzer(p.getAnalyzer())
 {
     setLookAndFeel(&lnf);
 
@@ -28,8 +30,40 @@ BitCrusherAudioProcessorEditor::BitCrusherAudioProcessorEditor (BitCrusherAudioP
     setRotarySlider(bitRate);
     setRotarySlider(mix);
     setRotarySlider(cutoff);
+
+    //the lfo knobs draw smaller with the amount in the middle, the source each one follows is a parameter of its own
+    const std::array<juce::String, ModulationBlock::numTargets> modTargets{ "bitDepth", "bitRate", "cutoff", "mix" };
+    for (size_t t = 0; t < modAmount.size(); ++t)
+    {
+        setRotarySlider(modAmount[t]);
+        modAmount[t].setComponentID("LFO");
+        modAmountAT[t] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, modTargets[t] + "ModAmount", modAmount[t]);
+        setChoiceBox(modSource[t], modTargets[t] + "ModSource", modSourceAT[t]);
+    }
+
+    for (size_t i = 0; i < lfoRate.size(); ++i)
+    {
+        const auto lfo = "lfo" + juce::String(i + 1);
+        setChoiceBox(lfoRate[i], lfo + "Rate", lfoRateAT[i]);
+        setChoiceBox(lfoShape[i], lfo + "Shape", lfoShapeAT[i]);
+    }
+
+    setRotarySlider(envAttack);
+    setRotarySlider(envRelease);
+    envAttack.setTooltip(envAttack.getName());
+    envRelease.setTooltip(envRelease.getName());
+    envAttackAT = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "envAttack", envAttack);
+    envReleaseAT = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "envRelease", envRelease);
+
+    setChoiceBox(oversampling, "oversampling", oversamplingAT);
+    addAndMakeVisible(analyzer);
     
-    setSize (800, 250);
+    //decoded once, the background image is rebuilt from these whenever the editor is resized
+    logo = juce::ImageCache::getFromMemory(BinaryData::KITIK_LOGO_NO_BKGD_png, BinaryData::KITIK_LOGO_NO_BKGD_pngSize);
+    newFont = juce::Font(juce::Typeface::createSystemTypefaceFor(BinaryData::offshore_ttf, BinaryData::offshore_ttfSize));
+
+    setSize (800, 250 + modulationHeight + analyzerHeight);
+    setWantsKeyboardFocus(BITCRUSHER_PROFILING != 0);
 
     startTimerHz(24);
 }
@@ -42,6 +76,19 @@ BitCrusherAudioProcessorEditor::~BitCrusherAudioProcessorEditor()
 //==============================================================================
 void BitCrusherAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    //everything static lives in the background image, so a repaint is just a blit of the dirty area
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void BitCrusherAudioProcessorEditor::renderBackground()
+{
+    //render at the display scale so the cached text and logo stay sharp on hi-dpi screens
+    auto scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    background = juce::Image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)), juce::jmax(1, juce::roundToInt(getHeight() * scale)), true);
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     auto bounds = getLocalBounds();
 
     auto grad = juce::ColourGradient::ColourGradient(juce::Colour(186u, 34u, 34u), bounds.toFloat().getBottomLeft(), juce::Colour(186u, 34u, 34u), bounds.toFloat().getTopRight(), false);
@@ -50,15 +97,11 @@ void BitCrusherAudioProcessorEditor::paint (juce::Graphics& g)
     g.setGradientFill(grad);
     g.fillAll();
 
-    auto inputMeter = bounds.removeFromLeft(bounds.getWidth() * .125);
-    auto meterLSide = inputMeter.removeFromLeft(inputMeter.getWidth() * .5);
-    meter[0].setBounds(meterLSide);
-    meter[1].setBounds(inputMeter);
-
-    auto outputMeter = bounds.removeFromRight(bounds.getWidth() * .14);
-    auto outMeterLSide = outputMeter.removeFromLeft(outputMeter.getWidth() * .5);
-    outMeter[0].setBounds(outMeterLSide);
-    outMeter[1].setBounds(outputMeter);
+    //same carving as resized(), the meters themselves are placed there
+    bounds.removeFromBottom(analyzerHeight);
+    bounds.removeFromBottom(modulationHeight);
+    bounds.removeFromLeft(bounds.getWidth() * .125);
+    bounds.removeFromRight(bounds.getWidth() * .14);
 
     g.setColour(juce::Colours::white);
 
@@ -69,11 +112,9 @@ void BitCrusherAudioProcessorEditor::paint (juce::Graphics& g)
     auto textSpace = infoSpace.removeFromRight(bounds.getWidth() * .4);
 
     //add logo
-    logo = juce::ImageCache::getFromMemory(BinaryData::KITIK_LOGO_NO_BKGD_png, BinaryData::KITIK_LOGO_NO_BKGD_pngSize);
     g.drawImage(logo, infoSpace.toFloat(), juce::RectanglePlacement::fillDestination);
 
     //Add Text
-    auto newFont = juce::Font(juce::Typeface::createSystemTypefaceFor(BinaryData::offshore_ttf, BinaryData::offshore_ttfSize));
     g.setColour(juce::Colours::whitesmoke);
     g.setFont(newFont);
     g.setFont(30.f);
@@ -83,7 +124,23 @@ void BitCrusherAudioProcessorEditor::paint (juce::Graphics& g)
 
 void BitCrusherAudioProcessorEditor::resized()
 {
+    renderBackground();
+
     auto bounds = getLocalBounds();
+    analyzer.setBounds(bounds.removeFromBottom(analyzerHeight).reduced(8, 0).withTrimmedBottom(8));
+
+    //the modulation sources share the strip evenly, the boxes fill their cell and the knobs sit square in theirs
+    auto modulationStrip = bounds.removeFromBottom(modulationHeight).reduced(8, 4);
+    const auto cellWidth = modulationStrip.getWidth() / (2 * static_cast<int>(lfoRate.size()) + 2);
+
+    for (size_t i = 0; i < lfoRate.size(); ++i)
+    {
+        lfoRate[i].setBounds(modulationStrip.removeFromLeft(cellWidth).reduced(4, 2));
+        lfoShape[i].setBounds(modulationStrip.removeFromLeft(cellWidth).reduced(4, 2));
+    }
+
+    envAttack.setBounds(modulationStrip.removeFromLeft(cellWidth).withSizeKeepingCentre(modulationStrip.getHeight(), modulationStrip.getHeight()));
+    envRelease.setBounds(modulationStrip.removeFromLeft(cellWidth).withSizeKeepingCentre(modulationStrip.getHeight(), modulationStrip.getHeight()));
 
     auto inputMeter = bounds.removeFromLeft(bounds.getWidth() * .125);
     auto meterLSide = inputMeter.removeFromLeft(inputMeter.getWidth() * .5);
@@ -96,18 +153,32 @@ void BitCrusherAudioProcessorEditor::resized()
     outMeter[1].setBounds(outputMeter);
 
     auto logoSpace = bounds.removeFromTop(bounds.getHeight() * .2);
+    oversampling.setBounds(logoSpace.removeFromRight(logoSpace.getWidth() * .1).reduced(2, 12));
+
+    //each control gets its modulation underneath it, the source on the left and the amount on the right
+    auto placeKnobs = [this](ModulationBlock::Target target, juce::Slider& knob, juce::Rectangle<int> area)
+    {
+        auto modArea = area.removeFromBottom(area.getHeight() * .3);
+        auto sourceArea = modArea.removeFromLeft(modArea.getWidth() / 2);
+        modSource[target].setBounds(sourceArea.withSizeKeepingCentre(sourceArea.getWidth() - 4, juce::jmin(sourceArea.getHeight(), 20)));
+        modAmount[target].setBounds(modArea.withSizeKeepingCentre(modArea.getHeight(), modArea.getHeight()));
+        knob.setBounds(area);
+    };
 
     auto depthBounds = bounds.removeFromLeft(bounds.getWidth() * .25);
-    bitDepth.setBounds(depthBounds);
+    placeKnobs(ModulationBlock::depth, bitDepth, depthBounds);
 
     auto rateBounds = bounds.removeFromLeft(bounds.getWidth() * .33);
-    bitRate.setBounds(rateBounds);
+    placeKnobs(ModulationBlock::rate, bitRate, rateBounds);
 
     auto mixBounds = bounds.removeFromLeft(bounds.getWidth() * .5);
-    mix.setBounds(mixBounds);
+    placeKnobs(ModulationBlock::mix, mix, mixBounds);
 
     auto cutoffBounds = bounds.removeFromLeft(bounds.getWidth());
-    cutoff.setBounds(cutoffBounds);
+    placeKnobs(ModulationBlock::cutoff, cutoff, cutoffBounds);
+
+    if (profilerOverlay != nullptr)
+        profilerOverlay->setBounds(getLocalBounds().reduced(getWidth() / 8, getHeight() / 5));
 }
 
 void BitCrusherAudioProcessorEditor::setRotarySlider(juce::Slider& slider)
@@ -118,14 +189,54 @@ void BitCrusherAudioProcessorEditor::setRotarySlider(juce::Slider& slider)
     addAndMakeVisible(slider);
 }
 
+void BitCrusherAudioProcessorEditor::setChoiceBox(juce::ComboBox& box, const juce::String& parameterID,
+                                                  std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment)
+{
+    //the items have to exist before the attachment is made or it can't show the saved choice
+    auto* parameter = audioProcessor.apvts.getParameter(parameterID);
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(parameter))
+        box.addItemList(choice->choices, 1);
+
+    if (parameter != nullptr)
+        box.setTooltip(parameter->getName(64));
+
+    attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, parameterID, box);
+    addAndMakeVisible(box);
+}
+
 void BitCrusherAudioProcessorEditor::timerCallback()
 {
-    //these get our rms level, and the set level function tells you how much of the rect you want
-    for (auto channel = 0; channel < audioProcessor.getTotalNumInputChannels(); channel++) {
-        meter[channel].setLevel(audioProcessor.getRMS(channel));
-        meter[channel].repaint();
+    //these get our rms level, and the set level function repaints only the part of the meter that moved
+    //on a surround bed the two meters follow the front left and right
+    auto& levels = audioProcessor.getMeters();
+    auto numMeters = juce::jmin(audioProcessor.getTotalNumInputChannels(), static_cast<int>(meter.size()));
+    for (auto channel = 0; channel < numMeters; channel++) {
+        meter[channel].setLevel(levels.getRMS(LevelMeters::input, channel));
+        outMeter[channel].setLevel(levels.getRMS(LevelMeters::output, channel));
+    }
+}
 
-        outMeter[channel].setLevel(audioProcessor.getOutRMS(channel));
-        outMeter[channel].repaint();
+bool BitCrusherAudioProcessorEditor::keyPressed(const juce::KeyPress& key)
+{
+   #if BITCRUSHER_PROFILING
+    if (key.getTextCharacter() == 'p' || key.getTextCharacter() == 'P')
+    {
+        if (profilerOverlay != nullptr)
+        {
+            profilerOverlay.reset();
+        }
+        else
+        {
+            profilerOverlay = std::make_unique<ProfilerOverlay>(audioProcessor.getProfiler());
+            addAndMakeVisible(*profilerOverlay);
+            resized();
+        }
+
+        return true;
     }
-}
\ No newline at end of file
+   #else
+    juce::ignoreUnused(key);
+   #endif
+
+    return false;
+}
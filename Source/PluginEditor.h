@@ -11,6 +11,8 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "KiTiKLNF.h"
+#include "ProfilerOverlay.h"
+#include "AnalyzerView.h"
 
 //==============================================================================
 /**
@@ -25,17 +27,22 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
     void timerCallback() override;
+    bool keyPressed(const juce::KeyPress& key) override;
 
     void setRotarySlider(juce::Slider&);
+    void setChoiceBox(juce::ComboBox&, const juce::String& parameterID, std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>&);
+    void renderBackground();
 
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     BitCrusherAudioProcessor& audioProcessor;
+    LevelMeters::ScopedConsumer meterConsumer;
 
     Laf lnf;
     juce::Image logo;
     juce::Font newFont;
+    juce::Image background;
 
     std::array<Laf::LevelMeter, 2> meter;
     std::array<Laf::LevelMeter, 2> outMeter;
@@ -47,5 +54,31 @@ private:
 
     juce::AudioProcessorValueTreeState::SliderAttachment bitDepthAT, bitRateAT, mixAT, cutoffAT;
 
+    //modulation amounts, a small knob under each control in ModulationBlock::Target order
+    std::array<juce::Slider, ModulationBlock::numTargets> modAmount;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, ModulationBlock::numTargets> modAmountAT;
+
+    //and where each amount comes from, in a box next to it
+    std::array<juce::ComboBox, ModulationBlock::numTargets> modSource;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>, ModulationBlock::numTargets> modSourceAT;
+
+    //the sources, in a strip above the analyzer: each lfo's rate and shape, then the envelope follower's times
+    std::array<juce::ComboBox, Modulators::numLfos> lfoRate, lfoShape;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>, Modulators::numLfos> lfoRateAT, lfoShapeAT;
+    juce::Slider envAttack { "Envelope Attack" },
+                 envRelease { "Envelope Release" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> envAttackAT, envReleaseAT;
+    static constexpr int modulationHeight = 40;
+
+    juce::ComboBox oversampling;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAT;
+
+    //spectrum and scope along the bottom, the processor only feeds it while the editor is open
+    AnalyzerView analyzer;
+    static constexpr int analyzerHeight = 150;
+
+    //'p' toggles it in builds with profiling compiled in, the profiler only records while it's open
+    std::unique_ptr<ProfilerOverlay> profilerOverlay;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BitCrusherAudioProcessorEditor)
 };
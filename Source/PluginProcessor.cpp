@@ -7,7 +7,13 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+
+#if ! BITCRUSHER_HEADLESS
+ #include "PluginEditor.h"
+#endif
+
+//the parameters each modulation target sits on, in ModulationBlock::Target order. the routing parameters add ModSource and ModAmount
+static const std::array<juce::String, ModulationBlock::numTargets> modulationTargetIds{ "bitDepth", "bitRate", "cutoff", "mix" };
 
 //==============================================================================
 BitCrusherAudioProcessor::BitCrusherAudioProcessor()
@@ -22,14 +28,58 @@ BitCrusherAudioProcessor::BitCrusherAudioProcessor()
                        )
 #endif
 {
-    bitDepth = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("bitDepth"));
-    bitRate = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("bitRate"));
+    bitDepth = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("bitDepth"));
+    bitRate = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("bitRate"));
     mix = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter("mix"));
     cutoff = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter("cutoff"));
+    oversampling = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter("oversampling"));
+    mixLaw = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter("mixLaw"));
+    bypass = dynamic_cast<juce::AudioParameterBool*> (apvts.getParameter("bypass"));
+    dither = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter("dither"));
+    filterType = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter("filterType"));
+    filterOrder = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter("filterOrder"));
+    resonance = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter("resonance"));
+    envAttack = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter("envAttack"));
+    envRelease = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter("envRelease"));
+
+    for (int i = 0; i < Modulators::numLfos; ++i)
+    {
+        const auto lfo = "lfo" + juce::String(i + 1);
+        lfoRate[static_cast<size_t>(i)] = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter(lfo + "Rate"));
+        lfoShape[static_cast<size_t>(i)] = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter(lfo + "Shape"));
+    }
+
+    for (size_t t = 0; t < modulationTargetIds.size(); ++t)
+    {
+        modSource[t] = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter(modulationTargetIds[t] + "ModSource"));
+        modAmount[t] = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter(modulationTargetIds[t] + "ModAmount"));
+    }
+
+    bands = dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter("bands"));
+
+    for (size_t c = 0; c < crossovers.size(); ++c)
+        crossovers[c] = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter("crossover" + juce::String(c + 1)));
+
+    for (size_t b = 0; b < bandDepth.size(); ++b)
+    {
+        const auto band = "band" + juce::String(b + 1);
+        bandDepth[b] = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter(band + "Depth"));
+        bandRate[b] = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter(band + "Rate"));
+        bandMix[b] = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter(band + "Mix"));
+    }
+
+    programValues = PresetState::buildProgramValues(getParameters(), bypass);
+
+    floatEngine.setProfiler(&profiler);
+    doubleEngine.setProfiler(&profiler);
+
+    apvts.addParameterListener("oversampling", this);
 }
 
 BitCrusherAudioProcessor::~BitCrusherAudioProcessor()
 {
+    apvts.removeParameterListener("oversampling", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -67,27 +117,55 @@ bool BitCrusherAudioProcessor::isMidiEffect() const
 
 double BitCrusherAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    //after the input stops the output still has the oversampling latency to come out, then the filter ringing and the
+    //last held sample, all of which the silence hold already waits out before the dsp idles. the longest hold is 1/100 s
+    const auto sampleRate = getSampleRate();
+    const auto latencySeconds = sampleRate > 0.0 ? getLatencySamples() / sampleRate : 0.0;
+
+    return latencySeconds + silenceHoldSeconds;
 }
 
 int BitCrusherAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return static_cast<int>(programValues.size());
 }
 
 int BitCrusherAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void BitCrusherAudioProcessor::setCurrentProgram (int index)
 {
+    if (! juce::isPositiveAndBelow(index, getNumPrograms()))
+        return;
+
+    currentProgram = index;
+
+    //setting the parameters notifies the host and the listeners, which has to happen on the message thread.
+    //some hosts switch programs from the audio thread, those calls are queued and applied from handleAsyncUpdate
+    if (juce::MessageManager::existsAndIsCurrentThread())
+    {
+        applyProgram(index);
+    }
+    else
+    {
+        pendingProgram.store(index);
+        triggerAsyncUpdate();
+    }
+}
+
+void BitCrusherAudioProcessor::applyProgram (int index)
+{
+    //one pass over a prebuilt float array. the continuous parameters glide to the new values and the discrete ones switch behind a short fade
+    auto& values = programValues[static_cast<size_t>(index)];
+    PresetState::apply(getParameters(), values.data(), static_cast<int>(values.size()));
 }
 
 const juce::String BitCrusherAudioProcessor::getProgramName (int index)
 {
-    return {};
+    auto& programs = PresetState::getFactoryPrograms();
+    return juce::isPositiveAndBelow(index, static_cast<int>(programs.size())) ? programs[static_cast<size_t>(index)].name : juce::String();
 }
 
 void BitCrusherAudioProcessor::changeProgramName (int index, const juce::String& newName)
@@ -97,22 +175,50 @@ void BitCrusherAudioProcessor::changeProgramName (int index, const juce::String&
 //==============================================================================
 void BitCrusherAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumOutputChannels();
-    spec.sampleRate = sampleRate;
-
-    for (auto& f : filters)
+    //only the engine for the precision the host asked for gets any memory
+    if (isUsingDoublePrecision())
     {
-        f.reset();
-        f.prepare(spec);
+        floatEngine.release();
+        doubleEngine.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(), getCrushSettings());
     }
+    else
+    {
+        doubleEngine.release();
+        floatEngine.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(), getCrushSettings());
+    }
+
+    updateLatency();
+
+    meters.prepare(sampleRate, getTotalNumOutputChannels());
+    profiler.prepare(sampleRate);
+    analyzer.prepare(sampleRate);
+    modulators.prepare(sampleRate, samplesPerBlock);
+    mixOffsets.assign(static_cast<size_t>(samplesPerBlock), 0.f);
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+
+    //the workers only ever start for an offline render, a realtime session never gets the threads
+    if (isNonRealtime())
+        channelWorkers->start();
+
+    smoothedMix.reset(sampleRate, .02);
+    smoothedMix.setCurrentAndTargetValue(mix->get());
+    smoothedBypass.reset(sampleRate, .02);
+    smoothedBypass.setCurrentAndTargetValue(bypass->get() ? 1.f : 0.f);
+    smoothedSwitch.reset(sampleRate, .01);
+    smoothedSwitch.setCurrentAndTargetValue(1.f);
+    activeSettings = getCrushSettings();
+
+    //the longest latency any oversampling can have, the hold has to outlast a switch made while it's idling
+    const auto maxLatency = isUsingDoublePrecision() ? doubleEngine.getMaxLatencySamples() : floatEngine.getMaxLatencySamples();
+    silenceHoldSamples = juce::roundToInt(sampleRate * silenceHoldSeconds) + maxLatency;
+    silentSamples = 0;
+    outputDecayed = false;
 }
 
 void BitCrusherAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    floatEngine.release();
+    doubleEngine.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -122,12 +228,10 @@ bool BitCrusherAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    //any mono, stereo, surround or discrete layout works, every channel runs the same chain.
+    //the cap is what the meters can hold, which covers everything up to 9.1.6
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    if (mainOutput.isDisabled() || mainOutput.size() > LevelMeters::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -141,103 +245,471 @@ bool BitCrusherAudioProcessor::isBusesLayoutSupported (const BusesLayout& layout
 }
 #endif
 
+template <typename SampleType>
+static bool isSilent(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples)
+{
+    //anything under -140 dB counts, that is around the last bit of 24 bit audio
+    constexpr auto threshold = static_cast<SampleType>(1.0e-7);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch), numSamples);
+        if (range.getStart() < -threshold || range.getEnd() > threshold)
+            return false;
+    }
+
+    return true;
+}
+
 void BitCrusherAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processInChunks(buffer, floatEngine);
+}
+
+void BitCrusherAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processInChunks(buffer, doubleEngine);
+}
+
+template <typename SampleType>
+void BitCrusherAudioProcessor::processInChunks (juce::AudioBuffer<SampleType>& buffer, CrushEngine<SampleType>& engine)
+{
+    const auto numSamples = buffer.getNumSamples();
+    if (numSamples <= maxBlockSize || maxBlockSize == 0)
+    {
+        processBlockImpl(buffer, engine);
+        return;
+    }
+
+    //the pieces point into the host's buffer, up to 32 channels that needs no allocation
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        juce::AudioBuffer<SampleType> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, juce::jmin(maxBlockSize, numSamples - start));
+        processBlockImpl(chunk, engine);
+    }
+}
+
+template <typename SampleType>
+void BitCrusherAudioProcessor::processBlockImpl (juce::AudioBuffer<SampleType>& buffer, CrushEngine<SampleType>& engine)
 {
     juce::ScopedNoDenormals noDenormals;
+    const ScopedAllocationGuard allocationGuard;
+    BITCRUSHER_PROFILE_BLOCK(profiler, buffer.getNumSamples());
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    //rms levels for meters
-    for (auto channel = 0; channel < totalNumInputChannels; channel++) {
-        rmsIn[channel] = juce::Decibels::gainToDecibels(buffer.getRMSLevel(channel, 0, buffer.getNumSamples()));
-        if (rmsIn[channel] < -60) { rmsIn[channel] = -60; }
+    const auto numSamples = buffer.getNumSamples();
+
+    //meters only cost anything while someone is looking at them
+    const auto metering = meters.isActive();
+    if (metering)
+    {
+        BITCRUSHER_PROFILE_STAGE(&profiler, metering);
+        meters.beginBlock(numSamples);
+
+        for (auto channel = 0; channel < totalNumInputChannels; channel++)
+            meters.measure(LevelMeters::input, channel, buffer.getReadPointer(channel), numSamples);
+    }
+
+    //same for the analyzer, with the editor closed nothing goes into its fifos
+    const auto analyzing = analyzer.isActive();
+    if (analyzing)
+    {
+        BITCRUSHER_PROFILE_STAGE(&profiler, metering);
+        analyzer.push(AnalyzerFeed::input, buffer, totalNumInputChannels, numSamples);
+    }
+
+    //fully bypassed, the crush chain doesn't run at all
+    smoothedBypass.setTargetValue(bypass->get() ? 1.f : 0.f);
+    if (! smoothedBypass.isSmoothing() && smoothedBypass.getTargetValue() == 1.f)
+    {
+        processBypassed(buffer, engine, metering, analyzing);
+        return;
     }
 
-    processBuffer.setSize(2, buffer.getNumSamples(), false, false, true);
-    processBuffer.clear();
+    //digital silence in, and the wet tail already gone: the output is silence too, so skip the lot
+    const auto inputSilent = isSilent(buffer, totalNumInputChannels, numSamples);
+    silentSamples = inputSilent ? silentSamples + numSamples : 0;
+
+    if (inputSilent && outputDecayed && silentSamples >= silenceHoldSamples)
+    {
+        //nothing gets rendered, but everything that counts samples moves on as if it had been,
+        //so the sound coming back in doesn't depend on where the host's blocks started and stopped the idling
+        auto settings = getCrushSettings();
+        updateDiscreteSettings(settings);
+
+        const auto& modulation = modulators.process(buffer, totalNumInputChannels, numSamples, getModulationSettings(), getTiming());
+        engine.skip(totalNumInputChannels, numSamples, settings, &modulation);
+
+        auto& dryDelay = engine.getDryDelay();
 
-    auto block = juce::dsp::AudioBlock<float>(processBuffer);
-    auto context = juce::dsp::ProcessContextReplacing<float>(block);
+        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+        {
+            buffer.clear(ch, 0, numSamples);
+            dryDelay.write(ch, buffer.getReadPointer(ch), numSamples);
+
+            if (metering)
+                meters.publish(LevelMeters::output, ch, 0.f, 0.f, numSamples);
+        }
+
+        if (analyzing)
+            analyzer.push(AnalyzerFeed::output, buffer, totalNumInputChannels, numSamples);
+
+        dryDelay.advance(numSamples);
+        smoothedMix.setTargetValue(mix->get());
+        smoothedMix.skip(numSamples);
+        smoothedBypass.skip(numSamples);
+        smoothedSwitch.skip(numSamples);
+        return;
+    }
+
+    //parameters are read once per block, the engine and the loops below only see plain values
+    auto settings = getCrushSettings();
+    updateDiscreteSettings(settings);
+
+    //the modulators read the input, so they go before anything is written back into the buffer
+    const auto& modulation = modulators.process(buffer, totalNumInputChannels, numSamples, getModulationSettings(), getTiming());
+    const auto mixModulated = modulation.isActive(ModulationBlock::mix);
+    if (mixModulated)
+        modulation.fill(ModulationBlock::mix, mixOffsets.data(), numSamples);
+
+    //the switch fade rides on the bypass amount, faded out is the same as bypassed
+    smoothedMix.setTargetValue(mix->get());
+    const auto mixSmoothing = smoothedMix.isSmoothing() || smoothedBypass.isSmoothing() || smoothedSwitch.isSmoothing() || mixModulated;
+    const auto equalPower = mixLaw->getIndex() == 1;
+    const auto gains = getMixGains(smoothedMix.getTargetValue(), 1.f - (1.f - smoothedBypass.getTargetValue()) * smoothedSwitch.getTargetValue(), equalPower);
+
+    auto inputBlock = juce::dsp::AudioBlock<SampleType>(buffer).getSubsetChannelBlock(0, static_cast<size_t>(totalNumInputChannels));
+
+    //big offline blocks split the channel groups across the workers, realtime always stays on the host's thread
+    auto* workers = isNonRealtime() && numSamples >= parallelBlockSize && channelWorkers->isRunning() ? channelWorkers.get() : nullptr;
+    auto wetBlock = engine.process(inputBlock, settings, &modulation, workers);
+
+    auto& dryDelay = engine.getDryDelay();
+    const auto dryDelayed = dryDelay.isActive();
 
     for (int ch = 0; ch < totalNumInputChannels; ++ch)
     {
-        float* processData = processBuffer.getWritePointer(ch);
-        const float* data = buffer.getReadPointer(ch);
-        updateFilter(ch);
+        auto* out = buffer.getWritePointer(ch);
+        const auto* wetData = wetBlock.getChannelPointer(static_cast<size_t>(ch));
+
+        //nothing to delay, ramp or measure: a plain crossfade the compiler can vectorise
+        if (! metering && ! mixSmoothing && ! dryDelayed)
+        {
+            BITCRUSHER_PROFILE_STAGE(&profiler, mix);
+            const auto dryGain = static_cast<SampleType>(gains.dry), wetGain = static_cast<SampleType>(gains.wet);
+            dryDelay.write(ch, out, numSamples);
+
+            for (int s = 0; s < numSamples; ++s)
+                out[s] = out[s] * dryGain + wetData[s] * wetGain;
+
+            continue;
+        }
+
+        //everything else is still one pass: delay the dry, crossfade, and take the output levels on the way.
+        //each channel walks its own copy of the mix and bypass ramps so they all get the same gains
+        auto mixRamp = smoothedMix;
+        auto bypassRamp = smoothedBypass;
+        auto switchRamp = smoothedSwitch;
+        auto dry = dryDelay.getChannel(ch);
+        auto dryGain = static_cast<SampleType>(gains.dry), wetGain = static_cast<SampleType>(gains.wet);
+        SampleType peak = 0, sumOfSquares = 0;
 
-        for (int s = 0; s < processBuffer.getNumSamples(); ++s)
+        //the output levels come out of the mix loop for free, so they count as mix time
         {
-            auto rawData = data[s];
-            auto crusher = pow(2, bitDepth->get());
-            auto crushedData = floor(crusher * rawData) / crusher;
-            processData[s] = (filters[ch].processSample(crushedData) * mix->get());
+            BITCRUSHER_PROFILE_STAGE(&profiler, mix);
 
-            if (bitRate->get() > 1)
+            for (int s = 0; s < numSamples; ++s)
             {
-                if (s % bitRate->get() != 0)
+                if (mixSmoothing)
                 {
-                    auto redux = processData[s - s % bitRate->get()];
-                    processData[s] = (redux * mix->get());
+                    auto mixAmount = mixRamp.getNextValue();
+                    if (mixModulated)
+                        mixAmount = juce::jlimit(0.f, 1.f, mixAmount + mixOffsets[static_cast<size_t>(s)]);
+
+                    auto g = getMixGains(mixAmount, 1.f - (1.f - bypassRamp.getNextValue()) * switchRamp.getNextValue(), equalPower);
+                    dryGain = static_cast<SampleType>(g.dry);
+                    wetGain = static_cast<SampleType>(g.wet);
                 }
+
+                auto y = dry.process(out[s]) * dryGain + wetData[s] * wetGain;
+                out[s] = y;
+                peak = juce::jmax(peak, std::abs(y));
+                sumOfSquares += y * y;
             }
         }
-        buffer.addFrom(ch, 0, processBuffer, ch, 0, processBuffer.getNumSamples());
+
+        if (metering)
+        {
+            BITCRUSHER_PROFILE_STAGE(&profiler, metering);
+            meters.publish(LevelMeters::output, ch, static_cast<float>(peak), static_cast<float>(sumOfSquares), numSamples);
+            meters.measureTruePeak(ch, out, numSamples);
+        }
+    }
+
+    if (analyzing)
+    {
+        BITCRUSHER_PROFILE_STAGE(&profiler, metering);
+        analyzer.push(AnalyzerFeed::output, buffer, totalNumInputChannels, numSamples);
+    }
+
+    dryDelay.advance(numSamples);
+    smoothedMix.skip(numSamples);
+    smoothedBypass.skip(numSamples);
+    smoothedSwitch.skip(numSamples);
+
+    //only worth checking while the input is silent, it decides whether the next silent block can idle
+    outputDecayed = inputSilent && isSilent(buffer, totalNumInputChannels, numSamples);
+}
+
+template <typename SampleType>
+void BitCrusherAudioProcessor::processBypassed (juce::AudioBuffer<SampleType>& buffer, CrushEngine<SampleType>& engine, bool metering, bool analyzing)
+{
+    //the dry still goes through the delay so bypassing doesn't shift the track against the latency the host compensates
+    auto& dryDelay = engine.getDryDelay();
+    const auto numSamples = buffer.getNumSamples();
+
+    for (int ch = 0; ch < getTotalNumInputChannels(); ++ch)
+    {
+        auto* data = buffer.getWritePointer(ch);
+
+        if (dryDelay.isActive())
+        {
+            auto dry = dryDelay.getChannel(ch);
+            for (int s = 0; s < numSamples; ++s)
+                data[s] = dry.process(data[s]);
+        }
+        else
+        {
+            dryDelay.write(ch, data, numSamples);
+        }
+
+        if (metering)
+        {
+            BITCRUSHER_PROFILE_STAGE(&profiler, metering);
+            meters.measure(LevelMeters::output, ch, data, numSamples);
+            meters.measureTruePeak(ch, data, numSamples);
+        }
+    }
+
+    if (analyzing)
+    {
+        BITCRUSHER_PROFILE_STAGE(&profiler, metering);
+        analyzer.push(AnalyzerFeed::output, buffer, getTotalNumInputChannels(), numSamples);
+    }
+
+    dryDelay.advance(numSamples);
+    silentSamples = 0;
+    outputDecayed = false;
+}
+
+
+BitCrusherAudioProcessor::MixGains BitCrusherAudioProcessor::getMixGains(float mix, float bypassAmount, bool equalPower)
+{
+    //linear keeps correlated signals at a steady level, equal power keeps the loudness steady when the crush has drifted far from the dry
+    MixGains gains{ 1.f - mix, mix };
+
+    if (equalPower)
+    {
+        auto angle = mix * juce::MathConstants<float>::halfPi;
+        gains = { std::cos(angle), std::sin(angle) };
+    }
+
+    return { bypassAmount + (1.f - bypassAmount) * gains.dry, (1.f - bypassAmount) * gains.wet };
+}
+
+void BitCrusherAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    triggerAsyncUpdate();
+}
+
+void BitCrusherAudioProcessor::handleAsyncUpdate()
+{
+    const auto program = pendingProgram.exchange(-1);
+    if (program >= 0)
+        applyProgram(program);
+
+    updateLatency();
+}
+
+void BitCrusherAudioProcessor::updateLatency()
+{
+    //the engine knows every oversampling's latency from prepare on, so this is what it will run at once the switch fade is through.
+    //setLatencySamples tells the host, which picks the new compensation up on its next restart
+    const auto index = oversampling->getIndex();
+    const auto latency = isUsingDoublePrecision() ? doubleEngine.getLatencySamples(index) : floatEngine.getLatencySamples(index);
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void BitCrusherAudioProcessor::updateDiscreteSettings(CrushSettings& settings)
+{
+    const auto changed = settings.oversamplingIndex != activeSettings.oversamplingIndex
+                      || settings.ditherType != activeSettings.ditherType
+                      || settings.filterType != activeSettings.filterType
+                      || settings.filterOrder != activeSettings.filterOrder
+                      || settings.numBands != activeSettings.numBands;
+
+    if (changed)
+    {
+        //once the wet path is fully out the new settings take over and it fades back in
+        if (smoothedSwitch.getCurrentValue() == 0.f)
+        {
+            activeSettings = settings;
+            smoothedSwitch.setTargetValue(1.f);
+        }
+        else
+        {
+            smoothedSwitch.setTargetValue(0.f);
+        }
+    }
+
+    settings.oversamplingIndex = activeSettings.oversamplingIndex;
+    settings.ditherType = activeSettings.ditherType;
+    settings.filterType = activeSettings.filterType;
+    settings.filterOrder = activeSettings.filterOrder;
+    settings.numBands = activeSettings.numBands;
+}
+
+CrushSettings BitCrusherAudioProcessor::getCrushSettings() const
+{
+    CrushSettings settings;
+    settings.bitDepth = bitDepth->get();
+    settings.bitRate = bitRate->get();
+    settings.cutoff = cutoff->get();
+    settings.oversamplingIndex = oversampling->getIndex();
+    settings.ditherType = dither->getIndex();
+    settings.filterType = filterType->getIndex();
+    settings.filterOrder = 2 << filterOrder->getIndex();
+    settings.resonance = resonance->get();
+
+    //the crossovers can't cross, each one sits at least where the one below it is
+    settings.numBands = bands->getIndex() + 1;
+    for (size_t c = 0; c < crossovers.size(); ++c)
+        settings.crossovers[c] = c == 0 ? crossovers[c]->get() : juce::jmax(settings.crossovers[c - 1], crossovers[c]->get());
+
+    for (size_t b = 0; b < settings.bands.size(); ++b)
+    {
+        settings.bands[b].bitDepth = bandDepth[b]->get();
+        settings.bands[b].bitRate = bandRate[b]->get();
+        settings.bands[b].mix = bandMix[b]->get();
+    }
+
+    return settings;
+}
+
+Modulators::Settings BitCrusherAudioProcessor::getModulationSettings() const
+{
+    Modulators::Settings settings;
+
+    for (size_t i = 0; i < lfoRate.size(); ++i)
+    {
+        settings.division[i] = lfoRate[i]->getIndex();
+        settings.shape[i] = lfoShape[i]->getIndex();
     }
 
-    //rms levels for meters
-    for (auto channel = 0; channel < totalNumInputChannels; channel++) {
-        rmsOut[channel] = juce::Decibels::gainToDecibels(buffer.getRMSLevel(channel, 0, buffer.getNumSamples()));
-        if (rmsOut[channel] < -60) { rmsOut[channel] = -60; }
+    settings.attackMs = envAttack->get();
+    settings.releaseMs = envRelease->get();
+
+    for (size_t t = 0; t < modSource.size(); ++t)
+    {
+        settings.source[t] = modSource[t]->getIndex();
+        settings.amount[t] = modAmount[t]->get();
     }
 
+    return settings;
+}
+
+Modulators::Timing BitCrusherAudioProcessor::getTiming() const
+{
+    //no play head, or one without a tempo, leaves the lfos running free at 120
+    Modulators::Timing timing;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            if (auto bpm = position->getBpm())
+                timing.bpm = *bpm;
+
+            if (auto ppq = position->getPpqPosition(); ppq.hasValue() && position->getIsPlaying())
+            {
+                timing.hasPosition = true;
+                timing.ppqPosition = *ppq;
+            }
+        }
+    }
+
+    return timing;
 }
 
 //==============================================================================
 bool BitCrusherAudioProcessor::hasEditor() const
 {
+   #if BITCRUSHER_HEADLESS
+    return false;
+   #else
     return true; // (change this to false if you choose to not supply an editor)
+   #endif
 }
 
 juce::AudioProcessorEditor* BitCrusherAudioProcessor::createEditor()
 {
+   #if BITCRUSHER_HEADLESS
+    return nullptr;
+   #else
     return new BitCrusherAudioProcessorEditor (*this);
     //return new juce::GenericAudioProcessorEditor(*this);
+   #endif
 }
 
 //==============================================================================
 void BitCrusherAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    //hosts ask for this constantly for undo and autosave, it's a header, a float per parameter and the ids
+    PresetState::write(getParameters(), currentProgram, destData);
 }
 
 void BitCrusherAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    int program = 0;
+    if (PresetState::read(getParameters(), data, sizeInBytes, program))
+    {
+        currentProgram = juce::jlimit(0, juce::jmax(0, getNumPrograms() - 1), program);
+        return;
+    }
+
+    //sessions saved before the binary format
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if (tree.isValid()) {
+        migrateLegacyBitRate(tree);
         apvts.replaceState(tree);
     }
 }
 
-void BitCrusherAudioProcessor::updateFilter(int channel)
+void BitCrusherAudioProcessor::migrateLegacyBitRate(juce::ValueTree& tree) const
 {
-    auto coeff = juce::dsp::IIR::Coefficients<float>::makeFirstOrderLowPass(getSampleRate(), cutoff->get());
-    filters[channel].coefficients = coeff;
-}
-
-float BitCrusherAudioProcessor::getRMS(int channel)
-{
-    jassert(channel == 0 || channel == 1);
-    return rmsIn[channel];
-}
-
-float BitCrusherAudioProcessor::getOutRMS(int channel)
-{
-    jassert(channel == 0 || channel == 1);
-    return rmsOut[channel];
+    //bitRate used to be a hold factor from 1 to 25 and is in Hz now. the two ranges don't overlap (the Hz one starts at 100),
+    //so anything up to 25 is an old factor and anything above was saved after the switch and is left alone
+    auto param = tree.getChildWithProperty("id", "bitRate");
+    if (! param.isValid())
+        return;
+
+    const auto value = static_cast<double>(param.getProperty("value"));
+    if (value > 25.0)
+        return;
+
+    //a factor of 1 held nothing, that's the top of the new range. the others held every n samples at the rate the host ran at
+    const auto factor = juce::jmax(1, juce::roundToInt(value));
+    const auto sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    const auto hz = factor == 1 ? 192000.0 : sampleRate / factor;
+
+    param.setProperty("value", juce::jlimit(100.0, 192000.0, hz), nullptr);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout BitCrusherAudioProcessor::createParameterLayout()
@@ -247,11 +719,53 @@ juce::AudioProcessorValueTreeState::ParameterLayout BitCrusherAudioProcessor::cr
 
     auto mixRange = NormalisableRange<float>(0, 1, .01);
     auto cutoffRange = NormalisableRange<float>(100, 20000, 1, .5);
+    auto rateRange = NormalisableRange<float>(100, 192000, 0, .25);
+    auto depthRange = NormalisableRange<float>(1, 16);
 
-    layout.add(std::make_unique<AudioParameterInt>("bitDepth", "bitDepth", 1, 16, 16));
-    layout.add(std::make_unique<AudioParameterInt>("bitRate", "Bit Rate", 1, 25, 1));
+    layout.add(std::make_unique<AudioParameterFloat>("bitDepth", "bitDepth", depthRange, 16));
+    layout.add(std::make_unique<AudioParameterFloat>("bitRate", "Bit Rate", rateRange, 192000));
     layout.add(std::make_unique<AudioParameterFloat>("mix", "Dry/Wet", mixRange, 1));
     layout.add(std::make_unique<AudioParameterFloat>("cutoff", "Cutoff Frequency", cutoffRange, 20000));
+    layout.add(std::make_unique<AudioParameterChoice>("oversampling", "Oversampling", StringArray{ "Off", "2x", "4x", "8x" }, 0));
+    layout.add(std::make_unique<AudioParameterChoice>("mixLaw", "Mix Law", StringArray{ "Linear", "Equal Power" }, 0));
+    layout.add(std::make_unique<AudioParameterBool>("bypass", "Bypass", false));
+    layout.add(std::make_unique<AudioParameterChoice>("dither", "Dither", StringArray{ "Off", "RPDF", "TPDF", "Shaped" }, 0));
+    layout.add(std::make_unique<AudioParameterChoice>("filterType", "Filter Type", StringArray{ "1st Order", "Butterworth", "Chebyshev", "SVF" }, 0));
+    layout.add(std::make_unique<AudioParameterChoice>("filterOrder", "Filter Order", StringArray{ "2nd", "4th", "8th" }, 0));
+    layout.add(std::make_unique<AudioParameterFloat>("resonance", "Resonance", NormalisableRange<float>(0, 1, .01), 0));
+
+    //modulation. every target picks a source and an amount, the defaults give each one a source so its amount knob works straight away
+    layout.add(std::make_unique<AudioParameterChoice>("lfo1Rate", "LFO 1 Rate", Modulators::getDivisionNames(), 5));
+    layout.add(std::make_unique<AudioParameterChoice>("lfo1Shape", "LFO 1 Shape", Modulators::getShapeNames(), 0));
+    layout.add(std::make_unique<AudioParameterChoice>("lfo2Rate", "LFO 2 Rate", Modulators::getDivisionNames(), 2));
+    layout.add(std::make_unique<AudioParameterChoice>("lfo2Shape", "LFO 2 Shape", Modulators::getShapeNames(), 1));
+    layout.add(std::make_unique<AudioParameterFloat>("envAttack", "Envelope Attack", NormalisableRange<float>(.1f, 100, 0, .5), 5));
+    layout.add(std::make_unique<AudioParameterFloat>("envRelease", "Envelope Release", NormalisableRange<float>(5, 1000, 0, .5), 150));
+
+    const std::array<String, ModulationBlock::numTargets> targetNames{ "Depth", "Rate", "Cutoff", "Mix" };
+    const std::array<int, ModulationBlock::numTargets> defaultSources{ Modulators::lfo1, Modulators::lfo2, Modulators::envelope, Modulators::lfo1 };
+
+    for (size_t t = 0; t < modulationTargetIds.size(); ++t)
+    {
+        layout.add(std::make_unique<AudioParameterChoice>(modulationTargetIds[t] + "ModSource", targetNames[t] + " Mod Source", Modulators::getSourceNames(), defaultSources[t]));
+        layout.add(std::make_unique<AudioParameterFloat>(modulationTargetIds[t] + "ModAmount", targetNames[t] + " Mod Amount", NormalisableRange<float>(-1, 1, .01), 0));
+    }
+
+    //multiband. off is the plain single band chain, the band defaults match the main controls so switching bands on changes nothing by itself
+    layout.add(std::make_unique<AudioParameterChoice>("bands", "Bands", StringArray{ "Off", "2 Bands", "3 Bands", "4 Bands" }, 0));
+
+    const std::array<float, CrushSettings::maxBands - 1> defaultCrossovers{ 250, 2000, 8000 };
+    for (size_t c = 0; c < defaultCrossovers.size(); ++c)
+        layout.add(std::make_unique<AudioParameterFloat>("crossover" + String(c + 1), "Crossover " + String(c + 1), NormalisableRange<float>(20, 20000, 1, .25), defaultCrossovers[c]));
+
+    for (int b = 1; b <= CrushSettings::maxBands; ++b)
+    {
+        const auto id = "band" + String(b);
+        const auto name = "Band " + String(b);
+        layout.add(std::make_unique<AudioParameterFloat>(id + "Depth", name + " Bit Depth", depthRange, 16));
+        layout.add(std::make_unique<AudioParameterFloat>(id + "Rate", name + " Bit Rate", rateRange, 192000));
+        layout.add(std::make_unique<AudioParameterFloat>(id + "Mix", name + " Mix", mixRange, 1));
+    }
 
     return layout;
 }
@@ -9,6 +9,19 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "AllocationGuard.h"
+#include "AnalyzerFeed.h"
+#include "ChannelWorkers.h"
+#include "CrushEngine.h"
+#include "Metering.h"
+#include "Modulation.h"
+#include "PresetState.h"
+#include "Profiling.h"
+
+//the offline renderer builds the processor on its own, without the editor or the plugin client
+#ifndef BITCRUSHER_HEADLESS
+ #define BITCRUSHER_HEADLESS 0
+#endif
 
 //==============================================================================
 /**
@@ -17,6 +30,8 @@ class BitCrusherAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                             , private juce::AudioProcessorValueTreeState::Listener
+                             , private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -32,6 +47,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    juce::AudioProcessorParameter* getBypassParameter() const override { return bypass; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,27 +75,105 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    void updateFilter(int channel);
-
-    float getRMS(int channel);
-    float getOutRMS(int channel);
+    LevelMeters& getMeters() { return meters; }
+    BlockProfiler& getProfiler() { return profiler; }
+    AnalyzerFeed& getAnalyzer() { return analyzer; }
 
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts{ *this, nullptr, "Parameters", createParameterLayout() };
 
 private:
 
-    std::array<juce::dsp::IIR::Filter<float>, 2> filters;
-    juce::AudioBuffer<float> processBuffer;
+    //the same dsp for both precisions, only the one the host uses is prepared
+    CrushEngine<float> floatEngine;
+    CrushEngine<double> doubleEngine;
+
+    //everything below is sized for the block size given to prepareToPlay. a host that sends more than that
+    //gets its block run through in pieces of at most that size
+    template <typename SampleType>
+    void processInChunks (juce::AudioBuffer<SampleType>&, CrushEngine<SampleType>&);
+
+    template <typename SampleType>
+    void processBlockImpl (juce::AudioBuffer<SampleType>&, CrushEngine<SampleType>&);
+
+    int maxBlockSize{ 0 };
+
+    CrushSettings getCrushSettings() const;
+    Modulators::Settings getModulationSettings() const;
+    Modulators::Timing getTiming() const;
+
+    //the reported latency follows the oversampling parameter. hosts may change parameters from the audio thread,
+    //so the change is only noted there and the latency gets reported from the message thread.
+    //programs picked off the message thread are applied from here as well
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void updateLatency();
+
+    //sessions from before bitRate was in Hz hold a sample and hold factor, converted before the tree is loaded
+    void migrateLegacyBitRate(juce::ValueTree& tree) const;
+
+    //bypass folds into the crossfade, at 1 it's the dry signal only
+    struct MixGains { float dry, wet; };
+    static MixGains getMixGains(float mix, float bypassAmount, bool equalPower);
+
+    template <typename SampleType>
+    void processBypassed (juce::AudioBuffer<SampleType>&, CrushEngine<SampleType>&, bool metering, bool analyzing);
+
+    LevelMeters meters;
+    BlockProfiler profiler;
+    AnalyzerFeed analyzer;
+
+    //offline renders with blocks at least this long run the engine's channel groups in parallel,
+    //below it handing the work over costs more than it saves
+    juce::SharedResourcePointer<ChannelWorkers> channelWorkers;
+    static constexpr int parallelBlockSize = 4096;
+
+    //lfos and the envelope follower, the engine takes the depth, rate and cutoff and the mix loop the mix.
+    //the mix offsets are spread out per sample once a block and every channel reads the same ones
+    Modulators modulators;
+    std::vector<float> mixOffsets;
+
+    //the mix is smoothed here, the engine smooths the rest of its own settings
+    juce::SmoothedValue<float> smoothedMix, smoothedBypass;
+
+    //discrete settings can't glide, so a change fades the wet path out, switches while it's silent and fades back in
+    juce::SmoothedValue<float> smoothedSwitch;
+    CrushSettings activeSettings;
+    void updateDiscreteSettings(CrushSettings& settings);
+
+    //factory programs as plain values in parameter order, built once so switching never allocates
+    std::vector<std::vector<float>> programValues;
+    int currentProgram{ 0 };
 
+    //a program picked off the message thread waits here for handleAsyncUpdate, -1 when there's none
+    std::atomic<int> pendingProgram{ -1 };
+    void applyProgram(int index);
 
-    std::array<float, 2> rmsIn;
-    std::array<float, 2> rmsOut;
+    //silence detection, once the input has been silent for a while and the output has died away the dsp idles
+    static constexpr double silenceHoldSeconds = .05;
+    int silenceHoldSamples{ 0 };
+    int silentSamples{ 0 };
+    bool outputDecayed{ false };
 
-    juce::AudioParameterInt* bitDepth{ nullptr };
-    juce::AudioParameterInt* bitRate{ nullptr };
+    juce::AudioParameterFloat* bitDepth{ nullptr };
+    juce::AudioParameterFloat* bitRate{ nullptr };
     juce::AudioParameterFloat* mix{ nullptr };
     juce::AudioParameterFloat* cutoff{ nullptr };
+    juce::AudioParameterChoice* oversampling{ nullptr };
+    juce::AudioParameterChoice* mixLaw{ nullptr };
+    juce::AudioParameterBool* bypass{ nullptr };
+    juce::AudioParameterChoice* dither{ nullptr };
+    juce::AudioParameterChoice* filterType{ nullptr };
+    juce::AudioParameterChoice* filterOrder{ nullptr };
+    juce::AudioParameterFloat* resonance{ nullptr };
+    std::array<juce::AudioParameterChoice*, Modulators::numLfos> lfoRate{}, lfoShape{};
+    juce::AudioParameterFloat* envAttack{ nullptr };
+    juce::AudioParameterFloat* envRelease{ nullptr };
+    std::array<juce::AudioParameterChoice*, ModulationBlock::numTargets> modSource{};
+    std::array<juce::AudioParameterFloat*, ModulationBlock::numTargets> modAmount{};
+    juce::AudioParameterChoice* bands{ nullptr };
+    std::array<juce::AudioParameterFloat*, CrushSettings::maxBands - 1> crossovers{};
+    std::array<juce::AudioParameterFloat*, CrushSettings::maxBands> bandDepth{}, bandRate{}, bandMix{};
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BitCrusherAudioProcessor)
 };
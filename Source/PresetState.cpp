@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+    PresetState.cpp
+    Created: 17 Oct 2026 10:21:52pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "PresetState.h"
+
+namespace PresetState
+{
+    static void writeUint32(char* dest, juce::uint32 value)
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(dest, &value, sizeof(value));
+    }
+
+    static void writeUint16(char* dest, juce::uint16 value)
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(dest, &value, sizeof(value));
+    }
+
+    static const juce::String& getId(juce::AudioProcessorParameter* parameter)
+    {
+        return static_cast<juce::RangedAudioParameter*>(parameter)->getParameterID();
+    }
+
+    juce::uint32 getLayoutHash(const juce::Array<juce::AudioProcessorParameter*>& parameters)
+    {
+        juce::uint32 hash = 2166136261u;
+        auto add = [&hash](juce::uint8 byte) { hash = (hash ^ byte) * 16777619u; };
+
+        //the terminator goes in too, so "ab" + "c" and "a" + "bc" hash differently
+        for (auto* parameter : parameters)
+        {
+            for (auto* c = getId(parameter).toRawUTF8(); *c != 0; ++c)
+                add(static_cast<juce::uint8>(*c));
+
+            add(0);
+        }
+
+        return hash;
+    }
+
+    void write(const juce::Array<juce::AudioProcessorParameter*>& parameters, int program, juce::MemoryBlock& dest)
+    {
+        const auto numValues = parameters.size();
+
+        //each id is a 16 bit byte count and the utf-8 bytes
+        size_t idBytes = 0;
+        for (auto* parameter : parameters)
+            idBytes += 2 + getId(parameter).getNumBytesAsUTF8();
+
+        dest.setSize(static_cast<size_t>(headerSize + numValues * 4) + idBytes, false);
+        auto* out = static_cast<char*>(dest.getData());
+
+        writeUint32(out, magic);
+        writeUint16(out + 4, version);
+        writeUint16(out + 6, static_cast<juce::uint16>(numValues));
+        writeUint32(out + 8, static_cast<juce::uint32>(program));
+        writeUint32(out + 12, getLayoutHash(parameters));
+        out += headerSize;
+
+        for (auto* parameter : parameters)
+        {
+            auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+            auto plain = ranged->convertFrom0to1(ranged->getValue());
+
+            juce::uint32 bits;
+            std::memcpy(&bits, &plain, sizeof(bits));
+            writeUint32(out, bits);
+            out += 4;
+        }
+
+        for (auto* parameter : parameters)
+        {
+            const auto& id = getId(parameter);
+            const auto numBytes = id.getNumBytesAsUTF8();
+            writeUint16(out, static_cast<juce::uint16>(numBytes));
+            std::memcpy(out + 2, id.toRawUTF8(), numBytes);
+            out += 2 + numBytes;
+        }
+    }
+
+    //the saved values lined up with the current layout by id, ids the layout doesn't have any more are dropped.
+    //false if the id region doesn't hold exactly one id per value, nothing is matched then
+    static bool matchById(const juce::Array<juce::AudioProcessorParameter*>& parameters, const char* values, int numValues,
+                          const char* ids, const char* end, std::vector<float>& matched)
+    {
+        //walk it once first, so a cut off or corrupt region is caught before anything is used
+        auto* check = ids;
+        for (int i = 0; i < numValues; ++i)
+        {
+            if (end - check < 2)
+                return false;
+
+            const auto numBytes = static_cast<int>(juce::ByteOrder::littleEndianShort(check));
+            if (end - check - 2 < numBytes)
+                return false;
+
+            check += 2 + numBytes;
+        }
+
+        matched.clear();
+
+        for (auto* parameter : parameters)
+        {
+            auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+            matched.push_back(ranged->convertFrom0to1(ranged->getDefaultValue()));
+        }
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            const auto numBytes = static_cast<int>(juce::ByteOrder::littleEndianShort(ids));
+
+            const auto id = juce::String::fromUTF8(ids + 2, numBytes);
+            ids += 2 + numBytes;
+
+            for (int p = 0; p < parameters.size(); ++p)
+            {
+                if (getId(parameters.getUnchecked(p)) == id)
+                {
+                    auto bits = juce::ByteOrder::littleEndianInt(values + i * 4);
+                    std::memcpy(&matched[static_cast<size_t>(p)], &bits, sizeof(bits));
+                    break;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool read(const juce::Array<juce::AudioProcessorParameter*>& parameters, const void* data, int sizeInBytes, int& program)
+    {
+        if (data == nullptr || sizeInBytes < headerSizeV1)
+            return false;
+
+        const auto* in = static_cast<const char*>(data);
+
+        if (juce::ByteOrder::littleEndianInt(in) != magic)
+            return false;
+
+        //a newer version than this build knows about might not be laid out the same, leave it alone
+        const auto stateVersion = juce::ByteOrder::littleEndianShort(in + 4);
+        if (stateVersion > version)
+            return false;
+
+        const auto stateHeaderSize = stateVersion < 2 ? headerSizeV1 : headerSize;
+        if (sizeInBytes < stateHeaderSize)
+            return false;
+
+        //every value the header counts has to be there, a cut off state is rejected rather than half loaded
+        const auto numValues = static_cast<int>(juce::ByteOrder::littleEndianShort(in + 6));
+        if (stateHeaderSize + numValues * 4 > sizeInBytes)
+            return false;
+
+        //saved with a different layout, find each value's parameter by id. without a complete id region there's no telling which is which
+        if (stateVersion >= 2 && juce::ByteOrder::littleEndianInt(in + 12) != getLayoutHash(parameters))
+        {
+            const auto* values = in + stateHeaderSize;
+            std::vector<float> matched;
+
+            if (! matchById(parameters, values, numValues, values + numValues * 4, in + sizeInBytes, matched))
+                return false;
+
+            program = static_cast<int>(juce::ByteOrder::littleEndianInt(in + 8));
+            apply(parameters, matched.data(), static_cast<int>(matched.size()));
+            return true;
+        }
+
+        program = static_cast<int>(juce::ByteOrder::littleEndianInt(in + 8));
+        in += stateHeaderSize;
+
+        //same layout, value i belongs to parameter i
+        std::array<float, 64> values;
+        jassert(parameters.size() <= static_cast<int>(values.size()));
+        const auto numToRead = juce::jmin(numValues, parameters.size(), static_cast<int>(values.size()));
+
+        for (int i = 0; i < numToRead; ++i)
+        {
+            auto bits = juce::ByteOrder::littleEndianInt(in + i * 4);
+            std::memcpy(&values[static_cast<size_t>(i)], &bits, sizeof(bits));
+        }
+
+        apply(parameters, values.data(), numToRead);
+        return true;
+    }
+
+    void apply(const juce::Array<juce::AudioProcessorParameter*>& parameters, const float* values, int numValues)
+    {
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            if (i < numValues && std::isnan(values[i]))
+                continue;
+
+            auto* ranged = static_cast<juce::RangedAudioParameter*>(parameters.getUnchecked(i));
+            auto normalised = i < numValues ? ranged->convertTo0to1(values[i]) : ranged->getDefaultValue();
+
+            //skipping the ones that are already there keeps the host's undo history and automation quiet
+            if (normalised != ranged->getValue())
+                ranged->setValueNotifyingHost(normalised);
+        }
+    }
+
+    const std::vector<FactoryProgram>& getFactoryPrograms()
+    {
+        static const std::vector<FactoryProgram> programs{
+            { "Init",           {} },
+            { "Lo-Fi Sampler",  { { "bitDepth", 12.f }, { "bitRate", 26040.f }, { "cutoff", 11000.f }, { "dither", 2.f } } },
+            { "8-Bit Console",  { { "bitDepth", 8.f }, { "bitRate", 16000.f }, { "cutoff", 7000.f } } },
+            { "Telephone",      { { "bitDepth", 8.f }, { "bitRate", 8000.f }, { "cutoff", 3400.f }, { "filterType", 1.f }, { "filterOrder", 1.f } } },
+            { "Parallel Grit",  { { "bitDepth", 6.f }, { "bitRate", 22050.f }, { "mix", .35f }, { "mixLaw", 1.f } } },
+            { "Smooth Crush",   { { "bitDepth", 5.f }, { "bitRate", 12000.f }, { "cutoff", 5000.f }, { "oversampling", 2.f }, { "dither", 3.f } } },
+            { "Resonant Steps", { { "bitDepth", 4.f }, { "bitRate", 6000.f }, { "cutoff", 2500.f }, { "filterType", 3.f }, { "resonance", .6f } } },
+            { "Destroyed",      { { "bitDepth", 2.f }, { "bitRate", 1500.f }, { "cutoff", 20000.f } } },
+            { "Eighth Wobble",  { { "bitDepth", 8.f }, { "bitRate", 16000.f }, { "cutoff", 3000.f }, { "cutoffModSource", 1.f }, { "cutoffModAmount", .5f }, { "lfo1Rate", 7.f } } },
+            { "Dynamic Grit",   { { "bitDepth", 12.f }, { "bitRate", 22050.f }, { "bitDepthModSource", 3.f }, { "bitDepthModAmount", -.6f }, { "envRelease", 80.f } } },
+            { "Crushed Highs",  { { "bands", 1.f }, { "crossover1", 3000.f }, { "band1Mix", 0.f }, { "band2Depth", 4.f }, { "band2Rate", 11025.f } } },
+        };
+
+        return programs;
+    }
+
+    std::vector<std::vector<float>> buildProgramValues(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                                                       const juce::AudioProcessorParameter* bypass)
+    {
+        std::vector<std::vector<float>> result;
+
+        for (auto& program : getFactoryPrograms())
+        {
+            std::vector<float> values;
+
+            for (auto* parameter : parameters)
+            {
+                if (parameter == bypass)
+                {
+                    values.push_back(std::numeric_limits<float>::quiet_NaN());
+                    continue;
+                }
+
+                auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+                auto value = ranged->convertFrom0to1(ranged->getDefaultValue());
+
+                for (auto& [id, programValue] : program.values)
+                    if (id == ranged->getParameterID())
+                        value = programValue;
+
+                values.push_back(value);
+            }
+
+            result.push_back(std::move(values));
+        }
+
+        return result;
+    }
+}
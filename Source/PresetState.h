@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    PresetState.h
+    Created: 17 Oct 2026 10:21:52pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Binary plugin state and the factory programs.
+//The state is a 16 byte header (magic, version, value count, program, layout hash) then every parameter's plain value
+//as a little endian float, in the order of the parameter layout, then the parameter ids in the same order.
+//The hash covers the ordered ids. When it matches the values load straight in by position, when it doesn't
+//(a parameter was added, moved or dropped since the state was saved) they're matched up by id instead,
+//and anything the state doesn't have goes back to its default.
+//Version 1 states have a 12 byte header and no hash or ids, those load by position.
+//A state that doesn't start with the magic number is the old ValueTree format and is left to the caller.
+namespace PresetState
+{
+    constexpr juce::uint32 magic = 0x53524342; //"BCRS"
+    constexpr juce::uint16 version = 2;
+    constexpr int headerSize = 16;
+    constexpr int headerSizeV1 = 12;
+
+    //fnv-1a over the ids in layout order, stable across builds and platforms
+    juce::uint32 getLayoutHash(const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+    void write(const juce::Array<juce::AudioProcessorParameter*>& parameters, int program, juce::MemoryBlock& dest);
+
+    //false if the data isn't in this format or is cut short, the parameters are untouched then
+    bool read(const juce::Array<juce::AudioProcessorParameter*>& parameters, const void* data, int sizeInBytes, int& program);
+
+    //sets every parameter from plain values in layout order, anything past the end of values goes back to its default.
+    //a NaN value leaves its parameter where it is
+    void apply(const juce::Array<juce::AudioProcessorParameter*>& parameters, const float* values, int numValues);
+
+    struct FactoryProgram
+    {
+        juce::String name;
+        std::vector<std::pair<juce::String, float>> values;
+    };
+
+    //only the parameters that differ from the defaults are listed
+    const std::vector<FactoryProgram>& getFactoryPrograms();
+
+    //the programs flattened into plain values in layout order, so switching programs is one pass over a float array.
+    //the host owns the bypass, a program leaves it alone (NaN in every program)
+    std::vector<std::vector<float>> buildProgramValues(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                                                       const juce::AudioProcessorParameter* bypass);
+}
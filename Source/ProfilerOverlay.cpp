@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    ProfilerOverlay.cpp
+    Created: 17 Oct 2026 10:48:21pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "ProfilerOverlay.h"
+
+ProfilerOverlay::ProfilerOverlay(BlockProfiler& p) : profiler(p), consumer(p)
+{
+    startTimerHz(10);
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    summary = profiler.getSummary();
+    repaint();
+}
+
+void ProfilerOverlay::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black.withAlpha(.8f));
+
+    auto bounds = getLocalBounds().reduced(8);
+    auto text = bounds.removeFromLeft(bounds.getWidth() / 2);
+
+    juce::String info;
+    info << "blocks " << static_cast<juce::int64>(summary.numBlocks) << "   overruns " << static_cast<juce::int64>(summary.numOverruns) << "\n"
+         << "load " << juce::String(summary.meanLoad * 100.f, 1) << "% mean, " << juce::String(summary.worstLoad * 100.f, 1) << "% worst\n"
+         << "block " << juce::String(summary.lastBlockUs, 1) << " us, worst " << juce::String(summary.worstBlockUs, 1) << " us\n"
+         << juce::String(summary.cyclesPerSample, 1) << " cycles / sample\n";
+
+    for (int i = 0; i < BlockProfiler::numStages; ++i)
+        info << BlockProfiler::getStageName(static_cast<BlockProfiler::Stage>(i)) << "  " << juce::String(summary.stageUs[static_cast<size_t>(i)], 1) << " us\n";
+
+    g.setColour(juce::Colours::whitesmoke);
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.f, juce::Font::plain));
+    g.drawMultiLineText(info, text.getX(), text.getY() + 11, text.getWidth());
+
+    //the histogram on a log scale so the rare slow blocks still show up next to the common ones
+    auto graph = bounds.toFloat();
+    auto mostBlocks = *std::max_element(summary.histogram.begin(), summary.histogram.end());
+    if (mostBlocks == 0)
+        return;
+
+    const auto barWidth = graph.getWidth() / static_cast<float>(BlockProfiler::numBins);
+    const auto top = std::log1p(static_cast<float>(mostBlocks));
+
+    for (int i = 0; i < BlockProfiler::numBins; ++i)
+    {
+        auto count = summary.histogram[static_cast<size_t>(i)];
+        if (count == 0)
+            continue;
+
+        auto height = graph.getHeight() * std::log1p(static_cast<float>(count)) / top;
+        auto overDeadline = static_cast<float>(i) * BlockProfiler::binWidth >= 1.f;
+
+        g.setColour(overDeadline ? juce::Colours::red : juce::Colours::whitesmoke);
+        g.fillRect(graph.getX() + barWidth * static_cast<float>(i), graph.getBottom() - height, juce::jmax(1.f, barWidth - 1.f), height);
+    }
+
+    //the deadline itself, everything right of it was an xrun
+    g.setColour(juce::Colours::red.withAlpha(.6f));
+    g.drawVerticalLine(juce::roundToInt(graph.getX() + graph.getWidth() * .5f), graph.getY(), graph.getBottom());
+}
+
+void ProfilerOverlay::mouseUp(const juce::MouseEvent& e)
+{
+    if (e.mods.isPopupMenu())
+    {
+        profiler.resetStatistics();
+        return;
+    }
+
+    chooser = std::make_unique<juce::FileChooser>("Save profiling trace", juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("BitCrusherTrace.json"), "*.json;*.csv");
+    chooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles | juce::FileBrowserComponent::warnAboutOverwriting,
+                         [this](const juce::FileChooser& fc)
+                         {
+                             auto file = fc.getResult();
+                             if (file != juce::File())
+                                 profiler.writeTrace(file);
+                         });
+}
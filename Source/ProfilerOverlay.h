@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    ProfilerOverlay.h
+    Created: 17 Oct 2026 10:48:21pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Profiling.h"
+
+//Sits on top of the editor and shows what the processor is costing: load against the block deadline,
+//the worst block so far, the per stage split and the load histogram. The profiler only records while this exists.
+//Click it to save the trace, .csv or .json. Right click clears the statistics.
+class ProfilerOverlay : public juce::Component, private juce::Timer
+{
+public:
+    explicit ProfilerOverlay(BlockProfiler& p);
+
+    void paint(juce::Graphics& g) override;
+    void mouseUp(const juce::MouseEvent& e) override;
+
+private:
+    BlockProfiler& profiler;
+    BlockProfiler::ScopedConsumer consumer;
+    BlockProfiler::Summary summary;
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
@@ -0,0 +1,276 @@
+/*
+  ==============================================================================
+
+    Profiling.cpp
+    Created: 17 Oct 2026 10:12:55pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "Profiling.h"
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+//the time stamp counter, it ticks at a fixed rate on anything recent so it reads as nominal cycles.
+//other cpus get 0 and the cycle columns just stay empty
+static juce::uint64 readCycleCounter()
+{
+   #if JUCE_INTEL
+    return static_cast<juce::uint64>(__rdtsc());
+   #else
+    return 0;
+   #endif
+}
+
+const char* BlockProfiler::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+        case oversampling: return "oversampling";
+        case quantize:     return "quantize";
+        case filter:       return "filter";
+        case decimate:     return "decimate";
+        case metering:     return "metering";
+        case mix:          return "mix";
+        default:           return "";
+    }
+}
+
+BlockProfiler::BlockProfiler()
+{
+    //the ring is the only big thing in here, builds without profiling never pay for it
+   #if BITCRUSHER_PROFILING
+    trace.resize(static_cast<size_t>(traceSize));
+   #endif
+
+    ticksToUs = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+}
+
+void BlockProfiler::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    samplePosition = 0;
+    clearStatistics();
+}
+
+void BlockProfiler::beginBlock(int numSamples)
+{
+    recording = isActive() && ! trace.empty();
+    if (! recording)
+        return;
+
+    if (resetRequested.exchange(false))
+        clearStatistics();
+
+    blockSamples = numSamples;
+    for (auto& ticks : stageTicks)
+        ticks.store(0, std::memory_order_relaxed);
+
+    blockStartCycles = readCycleCounter();
+    blockStartTicks = juce::Time::getHighResolutionTicks();
+}
+
+void BlockProfiler::endBlock()
+{
+    if (! recording)
+        return;
+
+    const auto elapsedTicks = juce::Time::getHighResolutionTicks() - blockStartTicks;
+    const auto cycles = readCycleCounter() - blockStartCycles;
+    recording = false;
+
+    const auto blockUs = static_cast<float>(static_cast<double>(elapsedTicks) * ticksToUs);
+    const auto deadlineUs = static_cast<double>(blockSamples) * 1.0e6 / sampleRate;
+    const auto load = deadlineUs > 0.0 ? static_cast<float>(blockUs / deadlineUs) : 0.f;
+
+    //single writer, so a plain load and store is enough and cheaper than a locked add
+    auto bin = juce::jlimit(0, numBins - 1, static_cast<int>(load / binWidth));
+    auto& count = histogram[static_cast<size_t>(bin)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (load >= 1.f)
+        numOverruns.store(numOverruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    loadSum += load;
+    ++loadCount;
+    meanLoad.store(static_cast<float>(loadSum / static_cast<double>(loadCount)), std::memory_order_relaxed);
+    lastBlockUs.store(blockUs, std::memory_order_relaxed);
+
+    if (load > worstLoad.load(std::memory_order_relaxed))
+        worstLoad.store(load, std::memory_order_relaxed);
+
+    if (blockUs > worstBlockUs.load(std::memory_order_relaxed))
+        worstBlockUs.store(blockUs, std::memory_order_relaxed);
+
+    if (blockSamples > 0)
+        cyclesPerSample.store(static_cast<float>(cycles) / static_cast<float>(blockSamples), std::memory_order_relaxed);
+
+    //the stage readouts average over about half a second whatever the block size
+    const auto smoothing = static_cast<float>(1.0 - std::exp(-deadlineUs / 5.0e5));
+    const auto index = traceWritten.load(std::memory_order_relaxed);
+    auto& record = trace[static_cast<size_t>(index % static_cast<juce::uint64>(traceSize))];
+
+    for (size_t i = 0; i < stageTicks.size(); ++i)
+    {
+        auto us = static_cast<float>(static_cast<double>(stageTicks[i].load(std::memory_order_relaxed)) * ticksToUs);
+        record.stageUs[i] = us;
+        stageAverage[i] += (us - stageAverage[i]) * smoothing;
+        stageUs[i].store(stageAverage[i], std::memory_order_relaxed);
+    }
+
+    record.time = static_cast<double>(samplePosition) / sampleRate;
+    record.numSamples = blockSamples;
+    record.blockUs = blockUs;
+    record.load = load;
+    record.cycles = cycles;
+    traceWritten.store(index + 1, std::memory_order_release);
+
+    samplePosition += blockSamples;
+}
+
+void BlockProfiler::clearStatistics()
+{
+    for (auto& count : histogram)
+        count.store(0, std::memory_order_relaxed);
+
+    for (auto& stage : stageUs)
+        stage.store(0.f, std::memory_order_relaxed);
+
+    numBlocks.store(0);
+    numOverruns.store(0);
+    meanLoad.store(0.f);
+    worstLoad.store(0.f);
+    lastBlockUs.store(0.f);
+    worstBlockUs.store(0.f);
+    cyclesPerSample.store(0.f);
+    traceWritten.store(0);
+
+    loadSum = 0.0;
+    loadCount = 0;
+    stageAverage.fill(0.f);
+}
+
+BlockProfiler::Summary BlockProfiler::getSummary() const
+{
+    Summary summary;
+    summary.numBlocks = numBlocks.load(std::memory_order_relaxed);
+    summary.numOverruns = numOverruns.load(std::memory_order_relaxed);
+    summary.meanLoad = meanLoad.load(std::memory_order_relaxed);
+    summary.worstLoad = worstLoad.load(std::memory_order_relaxed);
+    summary.lastBlockUs = lastBlockUs.load(std::memory_order_relaxed);
+    summary.worstBlockUs = worstBlockUs.load(std::memory_order_relaxed);
+    summary.cyclesPerSample = cyclesPerSample.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < stageUs.size(); ++i)
+        summary.stageUs[i] = stageUs[i].load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        summary.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+
+    return summary;
+}
+
+std::vector<BlockProfiler::Record> BlockProfiler::copyTrace() const
+{
+    //the audio thread keeps writing while this copies. afterwards, anything it could have lapped in the meantime gets dropped,
+    //the slot it's writing now belongs to the record traceSize blocks before the newest one
+    const auto size = static_cast<juce::uint64>(traceSize);
+    const auto end = traceWritten.load(std::memory_order_acquire);
+    auto begin = end > size ? end - size : juce::uint64();
+
+    std::vector<Record> records;
+    records.reserve(static_cast<size_t>(end - begin));
+
+    for (auto i = begin; i < end; ++i)
+        records.push_back(trace[static_cast<size_t>(i % size)]);
+
+    const auto after = traceWritten.load(std::memory_order_acquire);
+    if (after < end)
+        return {};
+
+    const auto firstValid = after >= size ? after - size + 1 : juce::uint64();
+    if (firstValid > begin)
+        records.erase(records.begin(), records.begin() + static_cast<std::ptrdiff_t>(juce::jmin(firstValid - begin, static_cast<juce::uint64>(records.size()))));
+
+    return records;
+}
+
+bool BlockProfiler::writeTrace(const juce::File& file) const
+{
+    const auto records = copyTrace();
+
+    if (file.hasFileExtension("csv"))
+    {
+        juce::String csv("time,samples,blockUs,load,cycles");
+        for (int i = 0; i < numStages; ++i)
+            csv << "," << getStageName(static_cast<Stage>(i)) << "Us";
+        csv << "\n";
+
+        for (auto& r : records)
+        {
+            csv << juce::String(r.time, 6) << "," << r.numSamples << "," << juce::String(r.blockUs, 2) << ","
+                << juce::String(r.load, 4) << "," << juce::String(static_cast<juce::int64>(r.cycles));
+
+            for (auto us : r.stageUs)
+                csv << "," << juce::String(us, 2);
+            csv << "\n";
+        }
+
+        return file.replaceWithText(csv);
+    }
+
+    const auto summary = getSummary();
+
+    auto* stages = new juce::DynamicObject();
+    for (size_t i = 0; i < summary.stageUs.size(); ++i)
+        stages->setProperty(getStageName(static_cast<Stage>(i)), summary.stageUs[i]);
+
+    juce::Array<juce::var> counts;
+    for (auto count : summary.histogram)
+        counts.add(static_cast<int>(count));
+
+    auto* histogramObject = new juce::DynamicObject();
+    histogramObject->setProperty("binWidth", binWidth);
+    histogramObject->setProperty("counts", counts);
+
+    juce::Array<juce::var> blocks;
+    for (auto& r : records)
+    {
+        auto* block = new juce::DynamicObject();
+        block->setProperty("time", r.time);
+        block->setProperty("samples", r.numSamples);
+        block->setProperty("blockUs", r.blockUs);
+        block->setProperty("load", r.load);
+        block->setProperty("cycles", static_cast<juce::int64>(r.cycles));
+
+        auto* blockStages = new juce::DynamicObject();
+        for (size_t i = 0; i < r.stageUs.size(); ++i)
+            blockStages->setProperty(getStageName(static_cast<Stage>(i)), r.stageUs[i]);
+        block->setProperty("stageUs", blockStages);
+
+        blocks.add(block);
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("plugin", "BitCrusher");
+    root->setProperty("sampleRate", sampleRate);
+    root->setProperty("blocks", static_cast<juce::int64>(summary.numBlocks));
+    root->setProperty("overruns", static_cast<juce::int64>(summary.numOverruns));
+    root->setProperty("meanLoad", summary.meanLoad);
+    root->setProperty("worstLoad", summary.worstLoad);
+    root->setProperty("worstBlockUs", summary.worstBlockUs);
+    root->setProperty("cyclesPerSample", summary.cyclesPerSample);
+    root->setProperty("stageUs", stages);
+    root->setProperty("histogram", histogramObject);
+    root->setProperty("trace", blocks);
+
+    return file.replaceWithText(juce::JSON::toString(juce::var(root)));
+}
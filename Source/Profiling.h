@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    Profiling.h
+    Created: 17 Oct 2026 10:12:55pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Per block timing of the processor. Each block records wall time, cpu cycles, its share of the block deadline
+//and how long each stage took. The audio thread publishes through relaxed atomics and an overwrite ring,
+//readers never block it. Like the meters it only records while a consumer is attached.
+//Debug builds have it compiled in, release builds compile every hook away unless BITCRUSHER_PROFILING is set.
+#ifndef BITCRUSHER_PROFILING
+ #if JUCE_DEBUG
+  #define BITCRUSHER_PROFILING 1
+ #else
+  #define BITCRUSHER_PROFILING 0
+ #endif
+#endif
+
+#if BITCRUSHER_PROFILING
+ #define BITCRUSHER_PROFILE_BLOCK(profiler, numSamples) const BlockProfiler::ScopedBlock JUCE_JOIN_MACRO(profiledBlock_, __LINE__) (profiler, numSamples)
+ #define BITCRUSHER_PROFILE_STAGE(profiler, stage) const BlockProfiler::ScopedStage JUCE_JOIN_MACRO(profiledStage_, __LINE__) (profiler, BlockProfiler::stage)
+#else
+ #define BITCRUSHER_PROFILE_BLOCK(profiler, numSamples)
+ #define BITCRUSHER_PROFILE_STAGE(profiler, stage)
+#endif
+
+class BlockProfiler
+{
+public:
+    enum Stage { oversampling, quantize, filter, decimate, metering, mix, numStages };
+    static const char* getStageName(Stage stage);
+
+    //load is the block's time over its deadline, 2% per bin and the last one catches everything from 198% up
+    static constexpr int numBins = 100;
+    static constexpr float binWidth = .02f;
+
+    //the last few thousand blocks, around ten seconds at 64 samples and 48k
+    static constexpr int traceSize = 8192;
+
+    BlockProfiler();
+
+    //============================================================================== audio side
+    void prepare(double sampleRate);
+
+    bool isActive() const { return numConsumers.load(std::memory_order_relaxed) > 0; }
+
+    void beginBlock(int numSamples);
+    void endBlock();
+
+    struct ScopedBlock
+    {
+        ScopedBlock(BlockProfiler& p, int numSamples) : profiler(p) { profiler.beginBlock(numSamples); }
+        ~ScopedBlock() { profiler.endBlock(); }
+
+    private:
+        BlockProfiler& profiler;
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    //a stage can run more than once a block (per channel, per smoothing step), the times add up.
+    //offline renders can run stages on the channel workers, so the adding is atomic and the total is cpu time
+    struct ScopedStage
+    {
+        ScopedStage(BlockProfiler* p, Stage s) : profiler(p != nullptr && p->recording ? p : nullptr), stage(s)
+        {
+            if (profiler != nullptr)
+                start = juce::Time::getHighResolutionTicks();
+        }
+
+        ~ScopedStage()
+        {
+            if (profiler != nullptr)
+                profiler->stageTicks[static_cast<size_t>(stage)].fetch_add(juce::Time::getHighResolutionTicks() - start, std::memory_order_relaxed);
+        }
+
+    private:
+        BlockProfiler* profiler;
+        Stage stage;
+        juce::int64 start = 0;
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    //============================================================================== reader side
+    struct Summary
+    {
+        juce::uint64 numBlocks = 0, numOverruns = 0;
+        float meanLoad = 0.f, worstLoad = 0.f;
+        float lastBlockUs = 0.f, worstBlockUs = 0.f;
+        float cyclesPerSample = 0.f;
+
+        //averaged over roughly the last half second
+        std::array<float, numStages> stageUs{};
+        std::array<juce::uint32, numBins> histogram{};
+    };
+
+    Summary getSummary() const;
+
+    //the audio thread does the clearing at its next block, so it stays the only writer
+    void resetStatistics() { resetRequested.store(true); }
+
+    //.csv gets one row per traced block, anything else gets json with the summary and histogram on top
+    bool writeTrace(const juce::File& file) const;
+
+    //profiling only runs while at least one of these is alive
+    struct ScopedConsumer
+    {
+        explicit ScopedConsumer(BlockProfiler& p) : profiler(p) { ++profiler.numConsumers; }
+        ~ScopedConsumer() { --profiler.numConsumers; }
+
+    private:
+        BlockProfiler& profiler;
+        JUCE_DECLARE_NON_COPYABLE(ScopedConsumer)
+    };
+
+private:
+    struct Record
+    {
+        double time;
+        int numSamples;
+        float blockUs, load;
+        juce::uint64 cycles;
+        std::array<float, numStages> stageUs;
+    };
+
+    std::vector<Record> trace;
+    std::atomic<juce::uint64> traceWritten{ 0 };
+
+    std::array<std::atomic<juce::uint32>, numBins> histogram{};
+    std::atomic<juce::uint64> numBlocks{ 0 }, numOverruns{ 0 };
+    std::atomic<float> meanLoad{ 0.f }, worstLoad{ 0.f }, lastBlockUs{ 0.f }, worstBlockUs{ 0.f }, cyclesPerSample{ 0.f };
+    std::array<std::atomic<float>, numStages> stageUs{};
+    std::array<std::atomic<juce::int64>, numStages> stageTicks{};
+
+    std::atomic<int> numConsumers{ 0 };
+    std::atomic<bool> resetRequested{ false };
+
+    //audio thread only
+    bool recording = false;
+    int blockSamples = 0;
+    juce::int64 blockStartTicks = 0;
+    juce::uint64 blockStartCycles = 0;
+    juce::int64 samplePosition = 0;
+    double loadSum = 0.0;
+    juce::uint64 loadCount = 0;
+    std::array<float, numStages> stageAverage{};
+
+    double sampleRate = 44100.0;
+    double ticksToUs = 0.0;
+
+    std::vector<Record> copyTrace() const;
+    void clearStatistics();
+};
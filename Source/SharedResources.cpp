@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    SharedResources.cpp
+    Created: 17 Oct 2026 9:47:15pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include "SharedResources.h"
+
+SharedResources::TruePeakCoefficients SharedResources::makeTruePeakCoefficients()
+{
+    //hann windowed sinc for each fractional phase, stored oldest sample first to match the history layout
+    TruePeakCoefficients table{};
+    constexpr auto centre = truePeakTaps / 2;
+
+    for (int phase = 1; phase < truePeakPhases; ++phase)
+    {
+        auto frac = static_cast<float>(phase) / truePeakPhases;
+        auto& coeffs = table[static_cast<size_t>(phase - 1)];
+        auto sum = 0.f;
+
+        for (int t = 0; t < truePeakTaps; ++t)
+        {
+            auto x = static_cast<float>(t - centre) + frac;
+            auto sinc = x == 0.f ? 1.f : std::sin(juce::MathConstants<float>::pi * x) / (juce::MathConstants<float>::pi * x);
+            auto window = .5f * (1.f + std::cos(juce::MathConstants<float>::pi * x / (centre + 1)));
+
+            coeffs[static_cast<size_t>(truePeakTaps - 1 - t)] = sinc * window;
+            sum += sinc * window;
+        }
+
+        for (auto& c : coeffs)
+            c /= sum;
+    }
+
+    return table;
+}
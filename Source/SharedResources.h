@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    SharedResources.h
+    Created: 17 Oct 2026 9:47:15pm
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "CrushKernel.h"
+
+//Read only DSP tables shared by every instance of the plugin in the process. The first instance builds
+//them and the last one frees them, hold one through juce::SharedResourcePointer<SharedResources>.
+//Nothing in here changes after construction, so audio threads read it without any locking.
+struct SharedResources
+{
+    static constexpr int truePeakTaps = 8;
+    static constexpr int truePeakPhases = 4;
+    using TruePeakCoefficients = std::array<std::array<float, truePeakTaps>, truePeakPhases - 1>;
+
+    //the quantizer, its kernels get picked for the cpu and checked against the reference maths once per process
+    const CrushKernel crusher;
+
+    //polyphase windowed sinc for the true peak meters, phase 0 is the sample itself so only phases 1-3 are stored
+    const TruePeakCoefficients truePeakCoefficients{ makeTruePeakCoefficients() };
+
+private:
+    static TruePeakCoefficients makeTruePeakCoefficients();
+};
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    CrushEngineTests.cpp
+    Created: 18 Oct 2026 5:21:08am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/CrushEngine.h"
+
+//The processor idles through silence with skip() instead of rendering it. Whatever comes after the silence has to
+//come out bit for bit the same as if the silent blocks had gone through process() instead, for any block size.
+//The settings glide the whole way through, so the ramps and the per step rates get checked as well as the hold grid.
+class CrushEngineTests : public juce::UnitTest
+{
+public:
+    CrushEngineTests() : juce::UnitTest("CrushEngine", "BitCrusher") {}
+
+    void runTest() override
+    {
+        beginTest("skipping silence, one band");
+        checkSkip<float>(getSettings(1));
+        checkSkip<double>(getSettings(1));
+
+        beginTest("skipping silence, three bands");
+        checkSkip<float>(getSettings(3));
+        checkSkip<double>(getSettings(3));
+
+        beginTest("skipping silence, oversampled");
+        auto settings = getSettings(1);
+        settings.oversamplingIndex = 1;
+        checkSkip<float>(settings);
+    }
+
+private:
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int numChannels = 2;
+    static constexpr int maxBlockSize = 512;
+    static constexpr int silenceLength = 1500;
+    static constexpr int signalLength = 1000;
+    static constexpr int signalBlockSize = 64;
+
+    //prepared at one place, rendered heading for another
+    static CrushSettings getStartSettings()
+    {
+        CrushSettings settings;
+        settings.bitRate = 8000.f;
+        return settings;
+    }
+
+    static CrushSettings getSettings(int numBands)
+    {
+        CrushSettings settings;
+        settings.bitDepth = 6.f;
+        settings.bitRate = 2500.f;
+        settings.cutoff = 6000.f;
+        settings.numBands = numBands;
+
+        settings.bands[0] = { 4.f, 1500.f, 1.f };
+        settings.bands[1] = { 8.f, 5000.f, 0.f };
+        settings.bands[2] = { 10.f, 700.f, .5f };
+        return settings;
+    }
+
+    template <typename SampleType>
+    void checkSkip(const CrushSettings& settings)
+    {
+        juce::AudioBuffer<SampleType> signal(numChannels, signalLength);
+        auto random = getRandom();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int s = 0; s < signalLength; ++s)
+                signal.setSample(ch, s, static_cast<SampleType>(random.nextDouble() * 2.0 - 1.0));
+
+        for (auto blockSize : { 7, 64, 500 })
+            expect(render<SampleType>(settings, signal, blockSize, false) == render<SampleType>(settings, signal, blockSize, true),
+                   "silence in blocks of " + juce::String(blockSize));
+    }
+
+    template <typename SampleType>
+    static std::vector<SampleType> render(const CrushSettings& settings, juce::AudioBuffer<SampleType>& signal, int silenceBlockSize, bool skipping)
+    {
+        CrushEngine<SampleType> engine;
+        engine.prepare(sampleRate, maxBlockSize, numChannels, getStartSettings());
+
+        juce::AudioBuffer<SampleType> silence(numChannels, maxBlockSize);
+        silence.clear();
+
+        for (int pos = 0; pos < silenceLength;)
+        {
+            const auto length = juce::jmin(silenceBlockSize, silenceLength - pos);
+
+            if (skipping)
+                engine.skip(numChannels, length, settings);
+            else
+                engine.process(juce::dsp::AudioBlock<SampleType>(silence).getSubBlock(0, static_cast<size_t>(length)), settings);
+
+            pos += length;
+        }
+
+        std::vector<SampleType> output;
+
+        for (int pos = 0; pos < signalLength; pos += signalBlockSize)
+        {
+            const auto length = juce::jmin(signalBlockSize, signalLength - pos);
+            auto wet = engine.process(juce::dsp::AudioBlock<SampleType>(signal).getSubBlock(static_cast<size_t>(pos), static_cast<size_t>(length)), settings);
+
+            for (size_t ch = 0; ch < wet.getNumChannels(); ++ch)
+                output.insert(output.end(), wet.getChannelPointer(ch), wet.getChannelPointer(ch) + length);
+        }
+
+        return output;
+    }
+};
+
+static CrushEngineTests crushEngineTests;
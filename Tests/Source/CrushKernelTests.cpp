@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    CrushKernelTests.cpp
+    Created: 18 Oct 2026 3:12:40am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/CrushKernel.h"
+
+//Every quantizer path against processReference, bit for bit. The runtime dispatch only ever picks one path
+//per machine, so each one is called directly here, whichever the cpu can run. Every depth, both precisions,
+//lengths around every simd width, start pointers off the alignment, and a guard either side of the output.
+class CrushKernelTests : public juce::UnitTest
+{
+public:
+    CrushKernelTests() : juce::UnitTest("CrushKernel", "BitCrusher") {}
+
+    void runTest() override
+    {
+        beginTest("scalar");
+        checkPath<float>(&CrushKernel::processScalar);
+        checkPath<double>(&CrushKernel::processScalar);
+
+       #if JUCE_INTEL
+        beginTest("sse2");
+        if (juce::SystemStats::hasSSE2())
+        {
+            checkPath<float>(&CrushKernel::processSSE2);
+            checkPath<double>(&CrushKernel::processSSE2);
+        }
+        else
+        {
+            logMessage("no sse2 on this cpu, skipped");
+        }
+
+        beginTest("avx2");
+        if (juce::SystemStats::hasAVX2())
+        {
+            checkPath<float>(&CrushKernel::processAVX2);
+            checkPath<double>(&CrushKernel::processAVX2);
+        }
+        else
+        {
+            logMessage("no avx2 on this cpu, skipped");
+        }
+       #endif
+
+        //the public entry points, whatever they picked for this cpu
+        beginTest("dispatched");
+        const CrushKernel crusher;
+
+        checkKernel<float>([&crusher](const float* src, float* dest, int n, int bits) { crusher.process(src, dest, n, bits); });
+        checkKernel<double>([&crusher](const double* src, double* dest, int n, int bits) { crusher.process(src, dest, n, bits); });
+        checkKernel<float>([&crusher](const float* src, float* dest, int n, int bits) { crusher.processFractional(src, dest, n, static_cast<float>(bits)); });
+        checkKernel<double>([&crusher](const double* src, double* dest, int n, int bits) { crusher.processFractional(src, dest, n, static_cast<double>(bits)); });
+    }
+
+private:
+    template <typename SampleType>
+    using Kernel = void (*)(const SampleType*, SampleType*, int, SampleType, SampleType);
+
+    //around every vector width for both precisions, so every tail length gets hit
+    const std::vector<int> lengths{ 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 65, 255, 257 };
+    static constexpr int maxOffset = 7;
+    static constexpr int guard = 16;
+
+    template <typename SampleType>
+    void checkPath(Kernel<SampleType> kernel)
+    {
+        checkKernel<SampleType>([kernel](const SampleType* src, SampleType* dest, int n, int bits)
+        {
+            const auto scale = static_cast<SampleType>(1 << bits);
+            kernel(src, dest, n, scale, SampleType(1) / scale);
+        });
+    }
+
+    template <typename SampleType, typename Function>
+    void checkKernel(Function&& kernel)
+    {
+        const auto maxLength = lengths.back();
+        const auto size = static_cast<size_t>(maxLength + maxOffset + 2 * guard);
+        const auto sentinel = static_cast<SampleType>(12345.678);
+
+        std::vector<SampleType> input(size), output(size), expected(static_cast<size_t>(maxLength));
+        auto random = getRandom();
+        auto numBad = 0;
+
+        for (int bits = 1; bits <= CrushKernel::maxBits; ++bits)
+        {
+            for (auto length : lengths)
+            {
+                for (int offset = 0; offset <= maxOffset; ++offset)
+                {
+                    auto* src = input.data() + guard + offset;
+                    fillInput(src, length, bits, random);
+                    CrushKernel::processReference(src, expected.data(), length, bits);
+
+                    //out of place with the guards checked, then in place
+                    std::fill(output.begin(), output.end(), sentinel);
+                    auto* dest = output.data() + guard + offset;
+                    kernel(src, dest, length, bits);
+
+                    auto ok = std::equal(expected.data(), expected.data() + length, dest)
+                           && std::all_of(output.begin(), output.begin() + guard + offset, [sentinel](SampleType v) { return v == sentinel; })
+                           && std::all_of(output.begin() + guard + offset + length, output.end(), [sentinel](SampleType v) { return v == sentinel; });
+
+                    kernel(src, src, length, bits);
+                    ok = ok && std::equal(expected.data(), expected.data() + length, src);
+
+                    if (! ok && ++numBad <= 10)
+                        expect(false, juce::String(sizeof(SampleType) == 4 ? "float" : "double") + ", " + juce::String(bits) + " bits, length "
+                                      + juce::String(length) + ", offset " + juce::String(offset));
+                }
+            }
+        }
+
+        expectEquals(numBad, 0, "mismatching cases");
+    }
+
+    //random samples past full scale both ways, plus the values that sit exactly on a step or a hair either side of one
+    template <typename SampleType>
+    static void fillInput(SampleType* dest, int length, int bits, juce::Random& random)
+    {
+        const auto step = SampleType(1) / static_cast<SampleType>(1 << bits);
+        const SampleType edges[] = { SampleType(0), -SampleType(0), SampleType(1), SampleType(-1), step, -step,
+                                     std::nextafter(step, SampleType(0)), std::nextafter(-step, SampleType(0)),
+                                     std::numeric_limits<SampleType>::min(), -std::numeric_limits<SampleType>::min() };
+
+        for (int s = 0; s < length; ++s)
+        {
+            if (random.nextInt(4) == 0)
+                dest[s] = edges[random.nextInt(juce::numElementsInArray(edges))];
+            else
+                dest[s] = static_cast<SampleType>((random.nextDouble() * 2.0 - 1.0) * 1.5);
+        }
+    }
+};
+
+static CrushKernelTests crushKernelTests;
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    DitherTests.cpp
+    Created: 18 Oct 2026 4:05:12am
+    Author:  kylew
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/Dither.h"
+
+//The noise has to line up with the samples, not with the calls: the same input in 7 sample calls and in one
+//call must come out identical for every mode, or the output would depend on the host's block size.
+class DitherTests : public juce::UnitTest
+{
+public:
+    DitherTests() : juce::UnitTest("Dither", "BitCrusher") {}
+
+    void runTest() override
+    {
+        beginTest("block size invariance, float");
+        checkBlockSizes<float>();
+
+        beginTest("block size invariance, double");
+        checkBlockSizes<double>();
+    }
+
+private:
+    static constexpr int numChannels = 2;
+    static constexpr int numSamples = 1001;
+
+    template <typename SampleType>
+    void checkBlockSizes()
+    {
+        const auto scale = static_cast<SampleType>(64);
+        std::vector<SampleType> input(numSamples);
+        auto random = getRandom();
+
+        for (auto& x : input)
+            x = static_cast<SampleType>(random.nextDouble() * 2.0 - 1.0);
+
+        for (auto type : { Dither<SampleType>::rpdf, Dither<SampleType>::tpdf, Dither<SampleType>::shaped })
+        {
+            auto whole = render<SampleType>(type, input, scale, numSamples);
+
+            for (auto blockSize : { 1, 7, 8, 13, 64 })
+            {
+                auto split = render<SampleType>(type, input, scale, blockSize);
+                expect(whole == split, "type " + juce::String(static_cast<int>(type)) + ", blocks of " + juce::String(blockSize));
+            }
+        }
+    }
+
+    template <typename SampleType>
+    static std::vector<SampleType> render(typename Dither<SampleType>::Type type, const std::vector<SampleType>& input, SampleType scale, int blockSize)
+    {
+        Dither<SampleType> dither;
+        dither.prepare(numChannels);
+
+        std::vector<SampleType> output(static_cast<size_t>(numChannels * numSamples));
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            const auto length = juce::jmin(blockSize, numSamples - pos);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* dest = output.data() + ch * numSamples + pos;
+
+                if (type == Dither<SampleType>::shaped)
+                    dither.processShaped(ch, input.data() + pos, dest, length, scale);
+                else
+                    dither.addNoise(type, ch, input.data() + pos, dest, length, scale);
+            }
+        }
+
+        return output;
+    }
+};
+
+static DitherTests ditherTests;
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+    Tests: runs every juce::UnitTest in the "BitCrusher" category and exits
+    with 1 if any of them failed, so CTest can run it as is.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    //a test name on the command line runs just that one
+    if (argc > 1)
+    {
+        for (auto* test : juce::UnitTest::getTestsInCategory("BitCrusher"))
+            if (test->getName() == juce::CharPointer_UTF8(argv[1]))
+                runner.runTests({ test });
+    }
+    else
+    {
+        runner.runTestsInCategory("BitCrusher");
+    }
+
+    auto numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    return runner.getNumResults() > 0 && numFailures == 0 ? 0 : 1;
+}